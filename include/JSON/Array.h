@@ -28,11 +28,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef JSON__ARRAY_H_
 #define JSON__ARRAY_H_
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
+#include "Iterator.h"
 #include "JSON.h"
 
 namespace JSON
@@ -82,6 +92,23 @@ namespace JSON
          */
         Array(std::istream& is, bool trace = false);
 
+        /**
+         * @brief construct a JSON array of the @a n values at @a data
+         *
+         * Booleans, integers, floating point numbers and strings are converted in
+         * bulk, long arrays of numbers are packed.
+         *
+         * @param data values of type bool, an integer or floating point type or std::string
+         * @param n number of values
+         * @throw Exception if an unsigned value does not fit a 64 bit integer
+         */
+        template<typename T>
+        Array(const T* data, std::size_t n, bool trace = false)
+            : Array(JSON::JNONE, trace)
+        {
+            createArray(data, n);
+        }
+
         /**
          * Destroy a JSON array freeing the
          * memory associated with the parser if
@@ -89,6 +116,20 @@ namespace JSON
          */
         virtual ~Array();
 
+        /**
+         * Reference the same parse tree as @a other
+         */
+        Array(const Array& other);
+
+        /**
+         * Take over the parse tree and place of @a other in constant time
+         */
+        Array(Array&& other) noexcept;
+
+        Array& operator=(const Array& rhs);
+
+        Array& operator=(Array&& rhs) noexcept;
+
         /**
          * @see JSON::getType(int)
          */
@@ -142,6 +183,68 @@ namespace JSON
          */
         std::size_t length() const;
 
+        /**
+         * @brief the elements converted in bulk to a vector
+         *
+         * @see copyTo(T*, std::size_t)
+         * @return a vector of length() values
+         */
+        template<typename T>
+        std::vector<T> toVector() const
+        {
+            std::vector<T> values(length());
+            copyAll(values);
+            return values;
+        }
+
+        /**
+         * @brief copy the elements converted in bulk to @a data
+         *
+         * Numbers are copied in one pass, a packed array of doubles at the speed of
+         * memcpy. Integers are the numbers truncated, like getLong(), and must fit
+         * in T.
+         *
+         * @param data room for @a n values of type bool, an integer or floating point type or std::string
+         * @param n size of @a data, at least length()
+         * @return the number of elements copied, length()
+         * @throw Exception if @a data is too small, an element is not of type T or out of its range
+         */
+        template<typename T>
+        std::size_t copyTo(T* data, std::size_t n) const
+        {
+            std::size_t size = length();
+            if(n < size)
+                THROW_MSG(Exception, "JSON array of " << size << " elements does not fit in " << n);
+
+            copyAll(data, size);
+            return size;
+        }
+
+#if __cplusplus >= 202002L
+        /**
+         * @see copyTo(T*, std::size_t)
+         */
+        template<typename T>
+        std::size_t copyTo(std::span<T> data) const
+        {
+            return copyTo(data.data(), data.size());
+        }
+#endif
+
+        typedef Iterator iterator;
+        typedef Iterator const_iterator;
+
+        /**
+         * @brief iterator to the first element of the array, for range-for loops
+         * @see JSON::begin()
+         */
+        Iterator begin() const;
+
+        /**
+         * @see JSON::end()
+         */
+        Iterator end() const;
+
         /**
          * @see JSON::isNull(int)
          */
@@ -260,6 +363,18 @@ namespace JSON
          */
         Array& put(int index, const Object& value);
 
+        /**
+         * @brief add pre-serialized JSON @a value at @a index in the JSON array
+         *
+         * This method replaces the value in this array at @a index with serialized JSON, if @a index is greater than or equal to length
+         * this method throws an JSONException. The text is copied verbatim when the array is printed, it is not parsed.
+         *
+         * @param index of parameter
+         * @param value serialized JSON value
+         * @return a reference to this JSON array
+         */
+        Array& put(int index, const RawJSON& value);
+
         /**
          * @brief add long @a value at @a index in the JSON array
          *
@@ -376,6 +491,18 @@ namespace JSON
             return append(value);
         }
 
+        /**
+         * @brief put pre-serialized JSON @a value at the end of the JSON array
+         *
+         * This method delegates to the equivalent append method
+         *
+         * @param value serialized JSON value
+         * @return a reference to this JSON array
+         */
+        Array& put(const RawJSON& value) {
+            return append(value);
+        }
+
         /**
          * @brief put long @a value at at the end of the JSON array
          *
@@ -486,6 +613,17 @@ namespace JSON
          */
         Array& append(const Object& value);
 
+        /**
+         * @brief append pre-serialized JSON @a value at end of the JSON array
+         *
+         * This method adds serialized JSON at the end of this array. The text is
+         * copied verbatim when the array is printed, it is not parsed.
+         *
+         * @param value serialized JSON value
+         * @return a reference to this JSON array
+         */
+        Array& append(const RawJSON& value);
+
         /**
          * @brief append long @a value at end of the JSON array
          *
@@ -534,12 +672,41 @@ namespace JSON
          */
         Array& remove(int index);
 
+        /**
+         * @brief freeze the array for fast read only access
+         *
+         * @see JSON::freeze()
+         * @return a reference to this JSON array
+         */
+        Array& freeze();
+
+        /**
+         * @brief freeze the array, storing identical subtrees once
+         *
+         * @see JSON::dedupe()
+         * @return the bytes saved
+         */
+        std::size_t dedupe();
+
+        /**
+         * @brief parse a JSON array, packing long arrays of numbers
+         * <p>
+         * Their numbers are held together instead of one node each and read
+         * through the getters as usual. Constructing from text does not pack.
+         *
+         * @see JSON::parse(const char*, bool)
+         * @param jsonstr JSON formatted UTF8 string
+         * @return the parsed array
+         */
+        static Array parsePacked(const std::string& jsonstr);
+
         /**
          * @brief return true if objects are equal
          *
-         * The objects are equal if the contained JSON is equal. A special
-         * case is added for null to speed up the comparison
+         * The objects are equal if the contained JSON is equal, members of objects
+         * within may be in any order.
          *
+         * @see JSON::equals(const JSON&, bool)
          * @return true if @a other object equals this object
          */
         bool operator==(const Array& other) const;
@@ -547,14 +714,134 @@ namespace JSON
         /**
          * @brief return true if objects are not equal
          *
-         * The objects are not equal if the contained JSON is not equal. A special
-         * case is added for null to speed up the comparison
+         * The objects are not equal if the contained JSON is not equal
          *
          * @param other
          * @return
          */
         bool operator!=(const Array& other) const;
 
+    private:
+
+        using JSON::createArray;
+
+        /**
+         * Other integer and floating point types go through std::int64_t and double
+         */
+        template<typename T>
+        void createArray(const T* data, std::size_t n)
+        {
+            createConverted(data, n, std::is_integral<T>());
+        }
+
+        template<typename T>
+        void createConverted(const T* data, std::size_t n, std::true_type)
+        {
+            std::vector<std::int64_t> values(n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                if(!std::numeric_limits<T>::is_signed
+                   && static_cast<std::uint64_t>(data[i]) > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+                    THROW_MSG(Exception, "value out of range for a JSON number: [" << i << "]");
+                values[i] = static_cast<std::int64_t>(data[i]);
+            }
+            createArray(values.data(), n);
+        }
+
+        template<typename T>
+        void createConverted(const T* data, std::size_t n, std::false_type)
+        {
+            static_assert(std::is_floating_point<T>::value, "JSON arrays hold booleans, numbers and strings");
+            std::vector<double> values(data, data + n);
+            createArray(values.data(), n);
+        }
+
+        void copyAll(double* data, std::size_t n) const
+        {
+            copyElements(0, data, n);
+        }
+
+        void copyAll(std::int64_t* data, std::size_t n) const
+        {
+            copyElements(0, data, n);
+        }
+
+        void copyAll(bool* data, std::size_t n) const
+        {
+            copyElements(0, data, n);
+        }
+
+        void copyAll(std::string* data, std::size_t n) const
+        {
+            copyElements(0, data, n);
+        }
+
+        template<typename T>
+        void copyAll(T* data, std::size_t n) const
+        {
+            copyConverted(data, n, std::is_integral<T>());
+        }
+
+        template<typename T>
+        void copyAll(std::vector<T>& values) const
+        {
+            if(!values.empty())
+                copyAll(values.data(), values.size());
+        }
+
+        void copyAll(std::vector<bool>& values) const
+        {
+            std::unique_ptr<bool[]> data(new bool[values.size()]);
+            copyAll(data.get(), values.size());
+            std::copy(data.get(), data.get() + values.size(), values.begin());
+        }
+
+        /**
+         * Integers are copied through a buffer of std::int64_t and range checked
+         */
+        template<typename T>
+        void copyConverted(T* data, std::size_t n, std::true_type) const
+        {
+            std::int64_t buffer[256];
+            for(std::size_t start = 0; start < n; start += 256)
+            {
+                std::size_t count = std::min<std::size_t>(256, n - start);
+                copyElements(start, buffer, count);
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    if(!fits<T>(buffer[i]))
+                        THROW_MSG(Exception, "JSON element out of range: [" << start + i << "]");
+                    data[start + i] = static_cast<T>(buffer[i]);
+                }
+            }
+        }
+
+        template<typename T>
+        void copyConverted(T* data, std::size_t n, std::false_type) const
+        {
+            static_assert(std::is_floating_point<T>::value, "JSON arrays hold booleans, numbers and strings");
+            double buffer[256];
+            for(std::size_t start = 0; start < n; start += 256)
+            {
+                std::size_t count = std::min<std::size_t>(256, n - start);
+                copyElements(start, buffer, count);
+                for(std::size_t i = 0; i < count; ++i)
+                {
+                    if(std::isfinite(buffer[i]) && std::fabs(buffer[i]) > std::numeric_limits<T>::max())
+                        THROW_MSG(Exception, "JSON element out of range: [" << start + i << "]");
+                    data[start + i] = static_cast<T>(buffer[i]);
+                }
+            }
+        }
+
+        template<typename T>
+        static bool fits(std::int64_t value)
+        {
+            if(std::numeric_limits<T>::is_signed)
+                return value >= static_cast<std::int64_t>(std::numeric_limits<T>::min())
+                    && value <= static_cast<std::int64_t>(std::numeric_limits<T>::max());
+            return value >= 0 && static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+        }
     };
 
 } /* namespace JSON */
@@ -0,0 +1,236 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__COMPACT_H_
+#define JSON__COMPACT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <JSON/JSON.h>
+
+struct cJSON_Compact;
+struct cJSON_CompactNode;
+
+namespace JSON
+{
+
+    /**
+     * A read only document in the compact node format of cJSON_CompactTree
+     * <p>
+     * Nodes take 24 bytes instead of a cJSON node and its key and string
+     * allocations, the children of an array or object are consecutive, and the
+     * whole document is a single allocation. Use it to hold large documents that
+     * are only read; Node::expand() turns any part back into a JSON tree.
+     */
+    class Compact
+    {
+        cJSON_Compact* m_doc;
+
+        Compact(const Compact& other);
+        Compact& operator=(const Compact& rhs);
+
+    public:
+        class Node;
+
+        /**
+         * A member name that remembers where it was last found
+         * <p>
+         * Objects with the same keys in the same order share a shape. Looking
+         * up a Field keeps the member's position in the shape, so the next
+         * object of that shape, such as the next record of an array, finds the
+         * member without looking at its key.
+         */
+        class Field
+        {
+            friend class Node;
+
+            std::string m_key;
+            mutable std::uint32_t m_shape;
+            mutable std::uint32_t m_position;
+
+        public:
+            explicit Field(const std::string& key)
+                : m_key(key)
+                , m_shape(0)
+                , m_position(0)
+            {
+            }
+
+            /**
+             * @return the member name
+             */
+            const std::string& key() const
+            {
+                return m_key;
+            }
+        };
+
+        /**
+         * A view of one node, valid while its Compact exists
+         */
+        class Node
+        {
+            friend class Compact;
+
+            const cJSON_Compact* m_doc;
+            const cJSON_CompactNode* m_node;
+
+            Node(const cJSON_Compact* doc, const cJSON_CompactNode* node)
+                : m_doc(doc)
+                , m_node(node)
+            {
+            }
+
+        public:
+            /**
+             * @return the JSON type of the node
+             */
+            JSON::Type getType() const;
+
+            /**
+             * @return the member name, empty for an array element or the root
+             */
+            std::string key() const;
+
+            /**
+             * @return the number of elements or members, 0 for other types
+             */
+            std::size_t size() const;
+
+            /**
+             * @brief get an element of an array or a member of an object by position,
+             * throws an Exception if out of range
+             */
+            Node operator[](int index) const;
+
+            /**
+             * @brief get a member of an object, case insensitive, throws an Exception
+             * if there is no such member
+             */
+            Node operator[](const std::string& key) const;
+
+            /**
+             * @brief get a member of an object, case insensitive, through the
+             * position @a field remembers, throws an Exception if there is no such member
+             */
+            Node operator[](const Field& field) const;
+
+            /**
+             * @return true if the node is an object with member @a key
+             */
+            bool has(const std::string& key) const;
+
+            /**
+             * @return true if the value is a JSON null
+             */
+            bool isNull() const;
+
+            /**
+             * @brief get a JSON boolean, throws an Exception if the value is not a boolean
+             */
+            bool getBoolean() const;
+
+            /**
+             * @brief get a JSON number as a double, throws an Exception if the value is not a number
+             */
+            double getDouble() const;
+
+            /**
+             * @brief get a JSON number as a long, throws an Exception if the value is not a number
+             */
+            long getLong() const;
+
+            /**
+             * @brief get a JSON string, any other type is returned as its JSON text
+             */
+            std::string getString() const;
+
+            /**
+             * @return compressed JSON text of the node
+             */
+            std::string toString() const;
+
+            /**
+             * @brief build the node and its children as a new parse tree
+             *
+             * @param value set to the new tree
+             */
+            void expand(JSON& value) const;
+
+        private:
+            /**
+             * @return the key or "[]", for exception messages
+             */
+            std::string describe() const;
+        };
+
+        /**
+         * Parse JSON text into a compact document
+         *
+         * @param json text to parse
+         */
+        explicit Compact(const std::string& json);
+
+        /**
+         * Parse JSON text into a compact document
+         *
+         * @param json text to parse
+         */
+        explicit Compact(const char* json);
+
+        /**
+         * Copy a parse tree into a compact document
+         *
+         * @param json tree to copy
+         */
+        explicit Compact(const JSON& json);
+
+        ~Compact();
+
+        /**
+         * @return the root node
+         */
+        Node root() const;
+
+        /**
+         * @return the bytes held by the document
+         */
+        std::size_t bytes() const;
+
+        /**
+         * @return the number of distinct object shapes
+         */
+        std::size_t shapes() const;
+
+    private:
+        static void own(JSON& value, cJSON* tree);
+    };
+
+} /* namespace JSON */
+#endif /* JSON__COMPACT_H_ */
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__DOCUMENT_H_
+#define JSON__DOCUMENT_H_
+
+#include <atomic>
+
+struct cJSON;
+
+namespace JSON
+{
+
+    /**
+     * Shared ownership of a cJSON parse tree
+     * <p>
+     * Every JSON object referencing a node of the tree holds one reference to its
+     * document, the tree is deleted when the last reference is released. The
+     * reference count is atomic, so views of one document may be created, copied
+     * and destroyed from several threads at once, while reading the tree is safe
+     * for as long as nothing modifies it.
+     * <p>
+     * A document whose tree is added to another tree hands its ownership on and
+     * keeps a reference to the new owner instead, so existing views remain valid.
+     */
+    class Document
+    {
+        std::atomic<long> m_refs;
+
+        /**
+         * The owned tree, NULL once adopted by another document
+         */
+        cJSON* m_root;
+
+        /**
+         * The document that adopted the tree, kept alive by this one
+         */
+        Document* m_owner;
+
+        explicit Document(cJSON* root);
+        ~Document();
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+    public:
+        /**
+         * Take ownership of a parse tree
+         * <p>
+         * The tree is deleted if the document cannot be allocated.
+         *
+         * @param root tree to own, may be NULL
+         * @return a document with one reference, NULL if root is NULL
+         */
+        static Document* create(cJSON* root);
+
+        /**
+         * Add a reference
+         */
+        void retain() noexcept
+        {
+            m_refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Drop a reference, deleting the document and its tree with the last one
+         */
+        void release() noexcept
+        {
+            if(m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        /**
+         * @return true if @a node is the root of the tree this document owns
+         */
+        bool owns(const cJSON* node) const
+        {
+            return node != 0 && node == m_root;
+        }
+
+        /**
+         * Hand the tree over to @a owner, after it has been added to a tree owned by @a owner
+         *
+         * @param owner document now owning the tree
+         */
+        void adopt(Document* owner) noexcept;
+    };
+
+} /* namespace JSON */
+#endif /* JSON__DOCUMENT_H_ */
@@ -81,5 +81,10 @@ throw exception(#exception, __FILE__, __LINE__, __PRETTY_FUNCTION__, oss.str());
         const std::string m_message;
     };
 
+    /**
+     * The name the Array and Object templates throw under
+     */
+    typedef Exception JSONException;
+
 }
 #endif /* JSON__EXCEPTION_H_ */
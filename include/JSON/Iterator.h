@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__ITERATOR_H_
+#define JSON__ITERATOR_H_
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#include <JSON/JSON.h>
+
+namespace JSON
+{
+
+    /**
+     * A lightweight reference to an element of an array or a member of an object,
+     * obtained by dereferencing an Iterator
+     * <p>
+     * The reference is only valid while the parse tree it points into is unchanged.
+     */
+    class Value
+    {
+        friend class Iterator;
+
+        /**
+         * The array or object being iterated, parent of views handed out
+         */
+        const JSON* m_parent;
+
+        /**
+         * The node in the parse tree
+         */
+        cJSON* m_item;
+
+        Value(const JSON* parent, cJSON* item)
+            : m_parent(parent)
+            , m_item(item)
+        {
+        }
+
+    public:
+#if __cplusplus >= 201703L
+        /**
+         * @return the member name, empty for an array element
+         */
+        std::string_view key() const
+        {
+            return m_item->string ? std::string_view(m_item->string, cJSON_GetKeyLength(m_item)) : std::string_view();
+        }
+#else
+        /**
+         * @return a copy of the member name, empty for an array element
+         */
+        std::string key() const
+        {
+            return m_item->string ? std::string(m_item->string, cJSON_GetKeyLength(m_item)) : std::string();
+        }
+#endif
+
+        /**
+         * @return the JSON type of the value
+         */
+        JSON::Type getType() const;
+
+        /**
+         * @return true if the value is a JSON null
+         */
+        bool isNull() const;
+
+        /**
+         * @brief get a JSON boolean, throws an Exception if the value is not a boolean
+         */
+        bool getBoolean() const;
+
+        /**
+         * @brief get a JSON number as a double, throws an Exception if the value is not a number
+         */
+        double getDouble() const;
+
+        /**
+         * @brief get a JSON number as a long, throws an Exception if the value is not a number
+         */
+        long getLong() const;
+
+        /**
+         * @brief get a JSON number as an integer, throws an Exception if the value is not a number
+         */
+        template<typename INTTYPE>
+        INTTYPE getInt() const
+        {
+            if((m_item->type & 255) != cJSON_Number)
+                THROW_MSG(Exception, "JSON element is not a number: " << describe());
+            return static_cast<INTTYPE>(m_item->valueint);
+        }
+
+        /**
+         * @brief get a JSON string, any other type is returned as its JSON text
+         */
+        std::string getString() const;
+
+        /**
+         * @brief reference a JSON array value, as JSON::getJSONArray does without a copy
+         *
+         * @param value set to reference the array
+         */
+        void getJSONArray(JSON& value) const;
+
+        /**
+         * @brief reference a JSON object value, as JSON::getJSONObject does without a copy
+         *
+         * @param value set to reference the object
+         */
+        void getJSONObject(JSON& value) const;
+
+        /**
+         * @return compressed JSON text of the value
+         */
+        std::string toString() const;
+
+    private:
+        /**
+         * @return the key or "[]" for an array element, for exception messages
+         */
+        std::string describe() const;
+    };
+
+    /**
+     * A forward iterator over the elements of an array or the members of an object
+     * <p>
+     * It steps along the parse tree, so a traversal is a single pass without
+     * lookups or allocation. Adding or removing elements invalidates iterators.
+     */
+    class Iterator
+    {
+        friend class JSON;
+
+        Value m_value;
+
+        Iterator(const JSON* parent, cJSON* item)
+            : m_value(parent, item)
+        {
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Value value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Value* pointer;
+        typedef const Value& reference;
+
+        reference operator*() const
+        {
+            return m_value;
+        }
+
+        pointer operator->() const
+        {
+            return &m_value;
+        }
+
+        Iterator& operator++()
+        {
+            m_value.m_item = m_value.m_item->next;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator it(*this);
+            m_value.m_item = m_value.m_item->next;
+            return it;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return m_value.m_item == rhs.m_value.m_item;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return m_value.m_item != rhs.m_value.m_item;
+        }
+    };
+
+} /* namespace JSON */
+#endif /* JSON__ITERATOR_H_ */
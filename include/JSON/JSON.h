@@ -35,13 +35,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <JSON/Exception.h>
 #include <JSON/cJSON/cJSON.h>
+#include <JSON/Document.h>
 #include <JSON/Enumeration.h>
+#include <JSON/RawJSON.h>
 
 struct cJSON;
 
 namespace JSON
 {
 
+    class Iterator;
+
 #if 0
 #define JTRACE JTrace __tracer(this, __FUNCTION__)
 #define JLOG(msg) log(__FUNCTION__, msg)
@@ -74,78 +78,64 @@ namespace JSON
             JBOOLEAN,
             JSTRING,
             JNUMBER,
-            JNULL
+            JNULL,
+            JRAW
         };
 
     private:
         /**
-         * trace memory allocation and chain management to cout
+         * trace memory allocation and document sharing to cout
          *
          * If an object is created by copy or assigned
          * the trace attribute is inherited.
          */
         bool m_trace;
 
+        /**
+         * match object keys exactly instead of ignoring ASCII case
+         *
+         * Inherited like the trace attribute.
+         */
+        bool m_caseSensitive;
+
         /**
          * print a trace message
          */
         inline void log(const char* func, const char* msg) const
         {
             if(m_trace)
-                std::cout << "JSON TRACE self: " << (void*)m_self << " next: " << m_next << " prev: " << m_prev << " node: " << m_node << " root: " << m_root << "[(" << func << "): " << msg << "]" << std::endl;
+                std::cout << "JSON TRACE self: " << (const void*)this << " document: " << (const void*)m_doc << " node: " << m_node << "[(" << func << "): " << msg << "]" << std::endl;
         }
 
         /**
-         * Object chain to link in all objects that have a reference
-         * to a cJSON parse tree. If the node owning the parse tree
-         * is deleted, the parse tree ownership will be passed to the
-         * next object in the chain.
+         * The node in the parser tree this object references
          */
-        JSON* m_next;
+        cJSON* m_node;
 
         /**
-         * Doubly linked list to ease removal of a node
+         * Shared owner of the parse tree m_node belongs to, NULL without a node
          */
-        JSON* m_prev;
+        Document* m_doc;
 
         /**
-         * Cheat non const pointer used during copy construction
-         * to get a not const reference to this object.
+         * Reference @a node of the tree owned by @a doc, releasing the current document
          *
-         * Every large body of code has a sin and this is it,
-         * lose the constness of the node so it can be
-         * modified.
+         * @param doc document to share
+         * @param node node of the tree owned by doc
          */
-        JSON* m_self;
+        void attach(Document* doc, cJSON* node) noexcept;
 
         /**
-         * Add this object to the chain after node
-         *
-         * @param node after which this node is added
+         * Release the document and node, leaving this object empty
          */
-        void addSelf(const JSON* node) const;
+        void detach() noexcept;
 
         /**
-         * Remove self from chain, called when the referenced parse tree
-         * changes.
+         * Release the document and node and take ownership of a new tree
          *
-         * If this object just references a parse tree, it removes itself
-         * from the chain. If it owns the parse tree and there are other nodes
-         * in the chain, it transfers the tree to the next node in the chain
-         * before removing itself.
-         */
-        void removeSelf();
-
-        /**
-         * The underlying cJSON parser, NULL, if this is not
-         * the owning node
-         */
-        cJSON* m_root;
-
-        /**
-         * The node in the parser tree this object references
+         * @param root parse tree, may be NULL
          */
-        cJSON* m_node;
+        void own(cJSON* root);
 
         /**
          * Get the named item
@@ -175,8 +165,120 @@ namespace JSON
          */
         cJSON* getItem(int index, bool optional = false, bool copy = false) const;
 
+        /**
+         * Deep copy a node, node by node, into a new tree
+         *
+         * @param elem node to copy
+         * @return root of the copy, without a member name
+         */
+        static cJSON* duplicate(cJSON* elem);
+
+        /**
+         * Replace the named item with @a elem, which is deleted if there is no such item
+         *
+         * @param key name of item
+         * @param elem replacement, an allocation failure if 0
+         */
+        void replaceElement(const std::string& key, cJSON* elem);
+
     protected:
 
+        /**
+         * @brief replace the parse tree with a frozen copy for fast reading
+         * <p>
+         * The copy is a single allocation holding the nodes in depth first order,
+         * with large arrays and objects indexed and the keys and strings packed
+         * after them. All accessors work as before, anything changing the frozen
+         * tree throws an Exception. Other objects referencing the original tree
+         * are not affected. Freezing a frozen object does nothing.
+         */
+        void freeze();
+
+        /**
+         * @brief replace the parse tree with a frozen copy in which identical
+         * subtrees are stored once
+         * <p>
+         * Arrays, objects and strings that equal one earlier in the document are
+         * kept as references to it, as by cJSON_Dedupe(), and the result is
+         * frozen so nothing can change what they share. Other objects
+         * referencing the original tree are not affected.
+         *
+         * @return how many bytes smaller the result is than freeze() would make it
+         */
+        std::size_t dedupe();
+
+        /**
+         * @brief replace the parse tree with the snapshot in a file
+         * <p>
+         * The file is mapped read only, with no parsing or allocation. The file
+         * holds offsets, so the pages of the nodes are made writable in the
+         * private mapping and the offsets turned into pointers, each checked to
+         * stay inside the file; this reads every node, so loading takes time in
+         * proportion to the tree. The keys and strings are only read and stay
+         * shared with every other process mapping the file. The tree is frozen
+         * and the mapping lasts until the last object referencing it is gone.
+         *
+         * @param path snapshot file written by writeSnapshot()
+         * @throw Exception if the file is not a sound snapshot for this build
+         */
+        void mapSnapshot(const std::string& path);
+
+        /**
+         * @brief copy @a n elements of the array from index @a start to @a data
+         * <p>
+         * Numbers are copied in one pass, from the values of a packed array without
+         * making nodes. Integers are the numbers truncated, like getLong().
+         *
+         * @throw Exception if an element is not of the type copied or the array ends first
+         */
+        void copyElements(std::size_t start, double* data, std::size_t n) const;
+        void copyElements(std::size_t start, std::int64_t* data, std::size_t n) const;
+        void copyElements(std::size_t start, bool* data, std::size_t n) const;
+        void copyElements(std::size_t start, std::string* data, std::size_t n) const;
+
+        /**
+         * @brief replace the parse tree with an array of the @a n values at @a data
+         * <p>
+         * Long arrays of numbers are packed.
+         */
+        void createArray(const double* data, std::size_t n);
+        void createArray(const float* data, std::size_t n);
+        void createArray(const int* data, std::size_t n);
+        void createArray(const std::int64_t* data, std::size_t n);
+        void createArray(const bool* data, std::size_t n);
+        void createArray(const std::string* data, std::size_t n);
+
+        /**
+         * Replace the named item with @a elem or add it when there is none,
+         * with a single lookup.
+         *
+         * @param key name of item
+         * @param elem new item, an allocation failure if 0
+         */
+        void setItem(const std::string& key, cJSON* elem);
+
+        /**
+         * Replace the named item with the parse tree of @a value or add it
+         * when there is none, with a single lookup. The parse tree is
+         * transferred as by addItem(const std::string&, const JSON&).
+         *
+         * @param key name of item
+         * @param value owner of the parse tree to insert, or a view to copy
+         */
+        void setItem(const std::string& key, const JSON& value);
+
+        /**
+         * @brief iterator to the first element of an array or member of an object
+         *
+         * Any other type, or an object without a parse tree, gives an empty range.
+         */
+        Iterator begin() const;
+
+        /**
+         * @brief iterator past the last element of an array or member of an object
+         */
+        Iterator end() const;
+
         /**
          * Create an empty JSON parse tree of specified type. This can be used
          * to hold key value pairs and generate a JSON UTF8 string.
@@ -193,6 +295,12 @@ namespace JSON
 
         JSON(const JSON& other);
 
+        /**
+         * Take over the document reference and node of @a other,
+         * which is left without a node.
+         */
+        JSON(JSON&& other) noexcept;
+
         virtual ~JSON();
 
         /**
@@ -203,8 +311,9 @@ namespace JSON
          * be thrown.
          *
          * @param json a JSON formatted null terminated 'C' string
+         * @param packed pack long arrays of numbers, as cJSON_ParsePacked()
          */
-        void parse(const char* json);
+        void parse(const char* json, bool packed = false);
 
         /**
          * Get the JSON type encapsulated
@@ -307,7 +416,7 @@ namespace JSON
             JTRACE;
             cJSON *elem = getItem(key);
 
-            switch(elem->type)
+            switch(elem->type & 255)
             {
             case cJSON_Number:
                 return static_cast<INTTYPE>(elem->valueint);
@@ -414,7 +523,7 @@ namespace JSON
             if(0 == elem)
                 return defaultValue;
 
-            switch(elem->type)
+            switch(elem->type & 255)
             {
             case cJSON_Number:
                 return static_cast<INTTYPE>(elem->valueint);
@@ -518,7 +627,7 @@ namespace JSON
             JTRACE;
             cJSON *elem = getItem(index);
 
-            switch(elem->type)
+            switch(elem->type & 255)
             {
             case cJSON_Number:
                 return static_cast<INTTYPE>(elem->valueint);
@@ -625,7 +734,7 @@ namespace JSON
             if(0 == elem)
                 return defaultValue;
 
-            switch(elem->type)
+            switch(elem->type & 255)
             {
             case cJSON_Number:
                 return static_cast<INTTYPE>(elem->valueint);
@@ -722,7 +831,10 @@ namespace JSON
             if(0 == m_node)
                 THROW_MSG(Exception, "JSON node NULL");
 
-            if(m_node->type != cJSON_Object)
+            if(m_node->type & cJSON_IsFrozen)
+                THROW_MSG(Exception, "JSON is frozen");
+
+            if((m_node->type & 255) != cJSON_Object)
                 THROW_MSG(Exception, "expected JSON object");
 
             cJSON_AddNumberToObject(m_node, key.c_str(), static_cast<int64_t>(value));
@@ -746,13 +858,22 @@ namespace JSON
 
         /**
          * Add an aggregate item to this JSON object. This JSON object will take
-         * ownership of the underlying cJSON object tree.
+         * ownership of the underlying cJSON object tree, or of a deep copy of it
+         * when @a value is a view into another tree.
          *
          * @param key name of array or object
          * @param value JSON array or object
          */
         void addItem(const std::string& key, const JSON& value);
 
+        /**
+         * Add a pre-serialized JSON item to this JSON object.
+         *
+         * @param key name to add to object
+         * @param value serialized JSON copied verbatim when printed
+         */
+        void addItem(const std::string& key, const RawJSON& value);
+
         /**
          * Add a null item to this JSON object.
          *
@@ -787,7 +908,10 @@ namespace JSON
             if(0 == m_node)
                 THROW_MSG(Exception, "JSON node NULL");
 
-            if(m_node->type != cJSON_Array)
+            if(m_node->type & cJSON_IsFrozen)
+                THROW_MSG(Exception, "JSON is frozen");
+
+            if((m_node->type & 255) != cJSON_Array)
                 THROW_MSG(Exception, "expected JSON array");
 
             cJSON* elem = cJSON_CreateNumber(static_cast<int64_t>(value));
@@ -813,12 +937,20 @@ namespace JSON
 
         /**
          * Append an aggregate item to this JSON array. This JSON object will take
-         * ownership of the underlying cJSON object tree.
+         * ownership of the underlying cJSON object tree, or of a deep copy of it
+         * when @a value is a view into another tree.
          *
          * @param value JSON array or object
          */
         void addItem(const JSON& value);
 
+        /**
+         * Append a pre-serialized JSON item to this JSON array.
+         *
+         * @param value serialized JSON copied verbatim when printed
+         */
+        void addItem(const RawJSON& value);
+
         /**
          * Append a null item to this JSON array.
          */
@@ -854,33 +986,16 @@ namespace JSON
             if(0 == m_node)
                 THROW_MSG(Exception, "JSON node NULL");
 
-            if(m_node->type != cJSON_Object)
-                THROW_MSG(Exception, "expected JSON object");
+            if(m_node->type & cJSON_IsFrozen)
+                THROW_MSG(Exception, "JSON is frozen");
 
-            cJSON* elem = cJSON_CreateNumber(static_cast<int64_t>(value));
-            if(0 == elem)
-                THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
+            if((m_node->type & 255) != cJSON_Object)
+                THROW_MSG(Exception, "expected JSON object");
 
-            cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+            replaceElement(key, cJSON_CreateNumber(static_cast<int64_t>(value)));
         }
 
 
-        /**
-         * Replace an integer number item in this JSON array.
-         *
-         * @param key name of value
-         * @param value integer number
-         */
-        void replaceItem(const std::string& key, std::int32_t value);
-
-        /**
-         * Replace an integer number item in this JSON array.
-         *
-         * @param key name of value
-         * @param value integer number
-         */
-        void replaceItem(const std::string& key, std::int64_t value);
-
         /**
          * Replace an long integer number item in this JSON array.
          *
@@ -906,13 +1021,23 @@ namespace JSON
 
         /**
          * Replace the value associated with key in this JSON object. This JSON object will take
-         * ownership of the underlying cJSON object tree.
+         * ownership of the underlying cJSON object tree, or of a deep copy of it
+         * when @a value is a view into another tree.
          *
          * @param key name of value
          * @param value new JSON array or object to associate with key
          */
         void replaceItem(const std::string& key, const JSON& value);
 
+        /**
+         * Replace the value associated with key in this JSON object with
+         * pre-serialized JSON.
+         *
+         * @param key name of value
+         * @param value serialized JSON copied verbatim when printed
+         */
+        void replaceItem(const std::string& key, const RawJSON& value);
+
         /**
          * Replace a boolean item in this JSON array.
          *
@@ -943,7 +1068,10 @@ namespace JSON
             if(0 == m_node)
                 THROW_MSG(Exception, "JSON node NULL");
 
-            if(m_node->type != cJSON_Array)
+            if(m_node->type & cJSON_IsFrozen)
+                THROW_MSG(Exception, "JSON is frozen");
+
+            if((m_node->type & 255) != cJSON_Array)
                 THROW_MSG(Exception, "expected JSON array");
 
             cJSON* elem = cJSON_CreateNumber(static_cast<int64_t>(value));
@@ -979,13 +1107,22 @@ namespace JSON
 
         /**
          * Replace an aggregate item in this JSON array. This JSON object will take
-         * ownership of the underlying cJSON object tree.
+         * ownership of the underlying cJSON object tree, or of a deep copy of it
+         * when @a value is a view into another tree.
          *
          * @param index of array or object
          * @param value JSON array or object
          */
         void replaceItem(int index, const JSON& value);
 
+        /**
+         * Replace an item in this JSON array with pre-serialized JSON.
+         *
+         * @param index of array or object
+         * @param value serialized JSON copied verbatim when printed
+         */
+        void replaceItem(int index, const RawJSON& value);
+
         /**
          * @brief remove the key from the object
          *
@@ -1010,6 +1147,12 @@ namespace JSON
 
         JSON& operator=(const JSON& rhs);
 
+        /**
+         * Release the current parse tree as the destructor does, then
+         * take the place of @a rhs as the move constructor does
+         */
+        JSON& operator=(JSON&& rhs) noexcept;
+
     public:
 
         /**
@@ -1034,11 +1177,9 @@ namespace JSON
         template<typename INTTYPE>
         JSON(INTTYPE val, bool trace = false)
             : m_trace(trace)
-            , m_next(0)
-            , m_prev(0)
-            , m_self(this)
-            , m_root(cJSON_CreateNumber(val))
-            , m_node(m_root)
+            , m_caseSensitive(false)
+            , m_node(cJSON_CreateNumber(val))
+            , m_doc(Document::create(m_node))
         {
             JTRACE;
             JLOG("constructed with cJSON_CreateNumber");
@@ -1082,6 +1223,65 @@ namespace JSON
          */
         std::string toString() const;
 
+        /**
+         * Convert to canonical JSON as defined by RFC 8785 (JSON Canonicalization Scheme)
+         * <p>
+         * Object keys are sorted by their UTF-16 code units, numbers are formatted
+         * as ECMAScript does and there is no whitespace, so documents that are equal
+         * apart from key order and number formatting give identical text. The keys
+         * are sorted in place of each object as it is written, the tree is not copied.
+         * Throws an Exception if the document holds a NaN or infinite number.
+         *
+         * @return canonical JSON UTF8 string
+         */
+        std::string toCanonicalString() const;
+
+        /**
+         * Convert to canonical JSON and hash the text as it is written
+         *
+         * @param hash set to the 64 bit FNV-1a hash of the canonical text
+         * @return canonical JSON UTF8 string
+         */
+        std::string toCanonicalString(std::uint64_t& hash) const;
+
+        /**
+         * Hash the canonical JSON text without keeping it, the text is hashed
+         * in small blocks as it is written. Equal to the hash returned by
+         * toCanonicalString(std::uint64_t&), suitable as a cache key.
+         *
+         * @return 64 bit FNV-1a hash of the canonical text
+         */
+        std::uint64_t canonicalHash() const;
+
+        /**
+         * Hash the parse tree directly, without serializing it
+         * <p>
+         * Objects that are equal() with the same @a ordered flag hash alike. Only a
+         * frozen tree is hashed again in constant time. A tree that can change has
+         * no links to parents, so a change deep down cannot reach the hash kept
+         * above it: every array or object holding arrays or objects is hashed
+         * again from its children on each call, and only large arrays and
+         * objects of plain values remember their hash, until one of their own
+         * children is added, removed or replaced. The
+         * value depends on the platform's byte order, it is meant for in-memory
+         * caches and sets, use canonicalHash() for a portable digest.
+         *
+         * @param seed hash seed
+         * @param ordered true if the order of object members should change the hash
+         * @return 64 bit hash of the content, @a seed for an object without a parse tree
+         */
+        std::uint64_t hash(std::uint64_t seed = 0, bool ordered = false) const;
+
+        /**
+         * @brief write the parse tree to a file for loading with mapSnapshot()
+         * <p>
+         * A snapshot is a frozen copy of the tree in the native layout, only a
+         * build of this library for the same platform can read it.
+         *
+         * @param path file to write
+         */
+        void writeSnapshot(const std::string& path) const;
+
         /**
          * Pretty print to stream
          *
@@ -1091,6 +1291,21 @@ namespace JSON
          */
         friend std::ostream& operator<<(std::ostream& os, const JSON& obj);
 
+        /**
+         * The log sink copies the parse tree for serialization on its own thread
+         */
+        friend class LogSink;
+
+        /**
+         * Iterator values hand out views of the parse tree
+         */
+        friend class Value;
+
+        /**
+         * Compact documents copy the parse tree and expand into new ones
+         */
+        friend class Compact;
+
         /**
          * @brief get an enumerator to enumerate the children of an object or array
          *
@@ -1100,6 +1315,22 @@ namespace JSON
          */
         Enumeration keys() const;
 
+        /**
+         * @brief match object keys exactly
+         *
+         * By default keys are compared ignoring ASCII case. The setting applies to
+         * lookups, replacement and removal through this object and is inherited by copies,
+         * not by objects or arrays obtained from it.
+         *
+         * @param caseSensitive true for exact matching
+         */
+        void setCaseSensitive(bool caseSensitive);
+
+        /**
+         * @return true if object keys are matched exactly
+         */
+        bool isCaseSensitive() const;
+
         /**
          * @brief is this object empty
          *
@@ -1113,6 +1344,25 @@ namespace JSON
          * @return true is this object is a JSON null
          */
         bool isNull() const;
+
+        /**
+         * @return true if the parse tree is frozen and cannot be changed
+         */
+        bool isFrozen() const;
+
+        /**
+         * @brief compare the parse trees directly
+         * <p>
+         * The trees are walked together and the comparison stops at the first
+         * difference, nothing is serialized or allocated. Numbers are equal if
+         * their values are, so 1, 1.0 and 1e0 match. Object members are matched
+         * by exact key. Two objects without a parse tree are equal.
+         *
+         * @param other object to compare with
+         * @param ordered true if object members must also be in the same order
+         * @return true if @a other holds the same JSON
+         */
+        bool equals(const JSON& other, bool ordered = false) const;
     };
 
 } /* namespace JSON */
@@ -0,0 +1,267 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__LOGSINK_H_
+#define JSON__LOGSINK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <JSON/Exception.h>
+#include <JSON/RawJSON.h>
+
+struct cJSON;
+
+namespace JSON
+{
+
+    class Object;
+
+    /**
+     * An asynchronous NDJSON log sink
+     * <p>
+     * Log entries are placed on a bounded lock-free ring buffer that any number of
+     * threads may write to. A single background thread serializes the entries, one
+     * JSON document per line, into large batches and writes each batch to the file
+     * descriptor with one write(). The calling thread only pays for the enqueue.
+     * <p>
+     * The file descriptor is not closed by the sink.
+     */
+    class LogSink
+    {
+    public:
+        /**
+         * What log() does when the ring buffer is full
+         */
+        enum Policy
+        {
+            /**
+             * wait for the background thread to make space
+             */
+            BLOCK = 0,
+            /**
+             * discard the new entry and count it as dropped
+             */
+            DROP
+        };
+
+        /**
+         * Fields captured on the calling thread and formatted as a JSON object
+         * on the background thread. Cheaper to build than an Object because
+         * no parse tree is allocated.
+         */
+        class Record
+        {
+            friend class LogSink;
+
+            enum Kind { KNULL, KBOOLEAN, KINTEGER, KDOUBLE, KSTRING, KRAW };
+
+            struct Field
+            {
+                std::string key;
+                Kind kind;
+                bool boolean;
+                std::int64_t integer;
+                double number;
+                std::string text;
+            };
+
+            std::vector<Field> m_fields;
+
+            Field& add(const std::string& key, Kind kind);
+
+        public:
+            /**
+             * @brief add boolean @a value as parameter @a key
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key, bool value);
+
+            /**
+             * @brief add double number @a value as parameter @a key
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key, double value);
+
+            /**
+             * @brief add integer number @a value as parameter @a key
+             *
+             * @return a reference to this record
+             */
+            template<typename INTTYPE>
+            typename std::enable_if<std::is_integral<INTTYPE>::value, Record&>::type
+            put(const std::string& key, INTTYPE value)
+            {
+                add(key, KINTEGER).integer = static_cast<std::int64_t>(value);
+                return *this;
+            }
+
+            /**
+             * @brief add string @a value as parameter @a key
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key, const std::string& value);
+
+            /**
+             * @brief convert const char* to string before insertion
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key, const char* value);
+
+            /**
+             * @brief add pre-serialized JSON @a value as parameter @a key
+             *
+             * Newlines in @a value, white space in valid JSON, are replaced by
+             * spaces here so the entry stays on one line.
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key, const RawJSON& value);
+
+            /**
+             * @brief add a null parameter @a key
+             *
+             * @return a reference to this record
+             */
+            Record& put(const std::string& key);
+        };
+
+    private:
+        /**
+         * A ring buffer slot. The sequence number tells producers and the
+         * consumer whose turn it is to use the slot.
+         */
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            cJSON* tree;
+            std::string text;
+            std::vector<Record::Field> fields;
+        };
+
+        const int m_fd;
+        const Policy m_policy;
+        const std::size_t m_batchBytes;
+        const std::size_t m_mask;
+        Slot* m_slots;
+
+        /**
+         * next position producers claim, and the consumer reads
+         */
+        std::atomic<std::size_t> m_tail;
+        std::size_t m_head;
+
+        /**
+         * positions below this have been written out
+         */
+        std::atomic<std::size_t> m_written;
+        std::atomic<std::size_t> m_dropped;
+
+        std::atomic<bool> m_stop;
+        std::atomic<bool> m_sleeping;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::condition_variable m_drained;
+        std::thread m_thread;
+
+        LogSink(const LogSink& other);
+        LogSink& operator=(const LogSink& rhs);
+
+        Slot* claim();
+        void publish(Slot* slot);
+        void run();
+        void write(std::string& batch, std::size_t entries);
+
+    public:
+        /**
+         * Start a sink writing to @a fd
+         *
+         * @param fd open file descriptor, for example a file opened for append
+         * @param capacity number of entries the ring buffer holds, rounded up to a power of two
+         * @param policy what to do when the ring buffer is full
+         * @param batchBytes a batch is written when it reaches this size or the buffer is empty
+         */
+        explicit LogSink(int fd, std::size_t capacity = 4096, Policy policy = BLOCK, std::size_t batchBytes = 64 * 1024);
+
+        /**
+         * Write out everything queued and stop the background thread
+         */
+        ~LogSink();
+
+        /**
+         * @brief queue a copy of @a obj
+         *
+         * The parse tree is copied node by node on the calling thread, which pays
+         * for the copy in proportion to the size of @a obj but may change it as
+         * soon as this returns. The copy is serialized on the background thread,
+         * newlines in raw values written as spaces. log(const Record&) copies less.
+         *
+         * @param obj JSON object to log
+         * @return false if the entry was dropped
+         */
+        bool log(const Object& obj);
+
+        /**
+         * @brief queue a record of captured fields
+         *
+         * @param record fields to log
+         * @return false if the entry was dropped
+         */
+        bool log(const Record& record);
+
+        /**
+         * @brief queue pre-serialized JSON, newlines in it are written as spaces
+         *
+         * @param json serialized JSON to log
+         * @return false if the entry was dropped
+         */
+        bool log(const RawJSON& json);
+
+        /**
+         * @brief wait until everything queued before the call has been written
+         */
+        void flush();
+
+        /**
+         * @return number of entries dropped because the buffer was full or a write failed
+         */
+        std::size_t dropped() const;
+    };
+
+} /* namespace JSON */
+#endif /* JSON__LOGSINK_H_ */
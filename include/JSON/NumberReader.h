@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__NUMBERREADER_H_
+#define JSON__NUMBERREADER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace JSON
+{
+
+    /**
+     * Decode arrays of numbers straight into typed buffers.
+     * <p>
+     * The text must be a JSON array whose elements are all numbers, or all
+     * arrays of exactly @a width numbers (tuples such as coordinates). Numbers are
+     * scanned by the same routine the cJSON parser uses, so values are identical
+     * to those of a parsed Array, but no cJSON nodes are created. Values are
+     * appended to the destination; on error an Exception is thrown and the
+     * destination may hold the values read before the error.
+     */
+    class NumberReader
+    {
+        NumberReader();
+
+    public:
+        /**
+         * Read a flat array of numbers.
+         *
+         * @param json text of the array, e.g. "[1,2.5,3]"
+         * @param values vector the numbers are appended to
+         * @return number of values read
+         */
+        static std::size_t
+        read(const std::string& json, std::vector<double>& values);
+
+        /**
+         * Read a flat array of integers. Fractional values are truncated as
+         * by JSON::getLong(); values outside the int64_t range throw.
+         *
+         * @param json text of the array
+         * @param values vector the numbers are appended to
+         * @return number of values read
+         */
+        static std::size_t
+        read(const std::string& json, std::vector<std::int64_t>& values);
+
+        /**
+         * Read an array of tuples, e.g. "[[1,2],[3,4]]" with @a width 2. The
+         * tuples are appended row after row.
+         *
+         * @param json text of the array
+         * @param width number of values in every tuple
+         * @param values vector the numbers are appended to
+         * @return number of tuples read
+         */
+        static std::size_t
+        read(const std::string& json, std::size_t width, std::vector<double>& values);
+
+        /**
+         * Integer version of read(const std::string&, std::size_t, std::vector<double>&).
+         */
+        static std::size_t
+        read(const std::string& json, std::size_t width, std::vector<std::int64_t>& values);
+
+        /**
+         * Read an array of tuples into a strided buffer: tuple @c r is stored at
+         * data[r * stride] ... data[r * stride + width - 1]. When @a width is 0
+         * the array is flat and every number is one row.
+         *
+         * @param json text of the array
+         * @param width number of values in every tuple, 0 for a flat array
+         * @param data buffer receiving the values
+         * @param stride distance between rows, at least max(width, 1)
+         * @param rows capacity of @a data in rows; more rows in the text throw
+         * @return number of rows read
+         */
+        static std::size_t
+        read(const std::string& json, std::size_t width, double* data, std::size_t stride, std::size_t rows);
+
+        /**
+         * Integer version of read(const std::string&, std::size_t, double*, std::size_t, std::size_t).
+         */
+        static std::size_t
+        read(const std::string& json, std::size_t width, std::int64_t* data, std::size_t stride, std::size_t rows);
+    };
+
+}
+
+#endif
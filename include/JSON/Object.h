@@ -35,6 +35,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 
 #include "Array.h"
+#include "Iterator.h"
 #include "JSON.h"
 
 namespace JSON
@@ -99,6 +100,20 @@ namespace JSON
          */
         virtual ~Object();
 
+        /**
+         * Reference the same parse tree as @a other
+         */
+        Object(const Object& other);
+
+        /**
+         * Take over the parse tree and place of @a other in constant time
+         */
+        Object(Object&& other) noexcept;
+
+        Object& operator=(const Object& rhs);
+
+        Object& operator=(Object&& rhs) noexcept;
+
         /**
          * @see JSON::getType(const std::string&)
          */
@@ -157,6 +172,20 @@ namespace JSON
          */
         std::size_t length() const;
 
+        typedef Iterator iterator;
+        typedef Iterator const_iterator;
+
+        /**
+         * @brief iterator to the first member of the object, for range-for loops
+         * @see JSON::begin()
+         */
+        Iterator begin() const;
+
+        /**
+         * @see JSON::end()
+         */
+        Iterator end() const;
+
         /**
          * @see JSON::isNull(const std::string&)
          */
@@ -204,10 +233,12 @@ namespace JSON
          * @see JSON::optJSONArray(const std::string&, JSON&, bool)
          * @return value for inline method calls, or Array::Null if key not present
          */
-        const Array optJSONArray(const std::string& key, bool copy = false) const
+        Array optJSONArray(const std::string& key, bool copy = false) const
         {
             Array val;
-            return optJSONArray(key, val, copy);
+            if(!JSON::optJSONArray(key, val, copy))
+                return Array::Null;
+            return val;
         }
 
         /**
@@ -222,10 +253,12 @@ namespace JSON
          * @see JSON::optJSONObject(const std::string&, JSON&, bool)
          * @return value for inline method calls, or Object::Null if key not present
          */
-        const Object optJSONObject(const std::string& key, bool copy = false) const
+        Object optJSONObject(const std::string& key, bool copy = false) const
         {
             Object val;
-            return optJSONObject(key, val, copy);
+            if(!JSON::optJSONObject(key, val, copy))
+                return Object::Null;
+            return val;
         }
 
         /**
@@ -269,10 +302,7 @@ namespace JSON
             if(key.empty())
                 THROW_MSG(JSONException, "no key provided for integer number value");
 
-            if(JSON::has(key))
-                replaceItem<INTTYPE>(key, value);
-            else
-                addItem<INTTYPE>(key, value);
+            setItem(key, cJSON_CreateNumber(static_cast<int64_t>(value)));
 
             return *this;
         }
@@ -301,6 +331,18 @@ namespace JSON
          */
         Object& put(const std::string& key, const Object& value);
 
+        /**
+         * @brief add pre-serialized JSON @a value as parameter @a key to the JSON object
+         *
+         * This method adds a serialized JSON @a value to this object with @a key as the parameter name, if @a key is empty
+         * this method throws an JSONException. The text is copied verbatim when the object is printed, it is not parsed.
+         *
+         * @param key name of parameter
+         * @param value serialized JSON value
+         * @return a reference to this JSON object
+         */
+        Object& put(const std::string& key, const RawJSON& value);
+
         /**
          * @brief add long number @a value as parameter @a key to the JSON object
          *
@@ -489,12 +531,49 @@ namespace JSON
          */
         Object& remove(const std::string& key);
 
+        /**
+         * @brief freeze the object for fast read only access
+         *
+         * @see JSON::freeze()
+         * @return a reference to this JSON object
+         */
+        Object& freeze();
+
+        /**
+         * @brief freeze the object, storing identical subtrees once
+         *
+         * @see JSON::dedupe()
+         * @return the bytes saved
+         */
+        std::size_t dedupe();
+
+        /**
+         * @brief parse a JSON object, packing long arrays of numbers
+         * <p>
+         * Their numbers are held together instead of one node each and read
+         * through the getters as usual. Constructing from text does not pack.
+         *
+         * @see JSON::parse(const char*, bool)
+         * @param jsonstr JSON formatted UTF8 string
+         * @return the parsed object
+         */
+        static Object parsePacked(const std::string& jsonstr);
+
+        /**
+         * @brief load an object from a snapshot file without parsing it
+         *
+         * @see JSON::mapSnapshot()
+         * @param path snapshot file written by JSON::writeSnapshot()
+         * @return the frozen object
+         */
+        static Object mapSnapshot(const std::string& path);
+
         /**
          * @brief return true if objects are equal
          *
-         * The objects are equal if the contained JSON is equal. A special
-         * case is added for null to speed up the comparison
+         * The objects are equal if the contained JSON is equal, members may be in any order.
          *
+         * @see JSON::equals(const JSON&, bool)
          * @return true if @a other object equals this object
          */
         bool operator==(const Object& other) const;
@@ -502,8 +581,7 @@ namespace JSON
         /**
          * @brief return true if objects are not equal
          *
-         * The objects are not equal if the contained JSON is not equal. A special
-         * case is added for null to speed up the comparison
+         * The objects are not equal if the contained JSON is not equal
          *
          * @param other
          * @return
@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__RAWJSON_H_
+#define JSON__RAWJSON_H_
+
+#include <string>
+
+#include <JSON/Exception.h>
+
+namespace JSON
+{
+
+    /**
+     * A fragment of already serialized JSON, for example a cached subdocument
+     * <p>
+     * A RawJSON value added to an Object or Array is stored as text and copied
+     * verbatim when the document is printed, it is never parsed into a tree.
+     * A raw value reads back with getString() and has type JSON::JRAW.
+     */
+    class RawJSON
+    {
+        std::string m_text;
+
+        void check(bool trusted) const;
+
+    public:
+        /**
+         * Wrap a serialized JSON value
+         * <p>
+         * Unless @a trusted is true the text is checked to be a single well formed
+         * JSON value. This is a single scan that builds no parse tree, text
+         * produced by JSON::toString() may be marked trusted to skip it. Empty or
+         * blank text is refused either way.
+         *
+         * @param text JSON formatted UTF-8 string
+         * @param trusted true if the text is known to be valid JSON
+         * @throw Exception if the text is empty, or not trusted and not valid
+         */
+        explicit RawJSON(const std::string& text, bool trusted = false);
+
+        /**
+         * @see RawJSON(const std::string&, bool)
+         */
+        explicit RawJSON(const char* text, bool trusted = false);
+
+        /**
+         * @return the serialized JSON
+         */
+        const std::string& str() const
+        {
+            return m_text;
+        }
+    };
+
+} /* namespace JSON */
+#endif /* JSON__RAWJSON_H_ */
@@ -0,0 +1,347 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__TEMPLATE_H_
+#define JSON__TEMPLATE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <JSON/Exception.h>
+#include <JSON/RawJSON.h>
+
+struct cJSON;
+
+namespace JSON
+{
+
+    class JSON;
+
+    /**
+     * A precompiled JSON response template
+     * <p>
+     * The skeleton is a JSON document where any string value of the form
+     * <code>"${name}"</code> or <code>"${name:type}"</code> is a placeholder.
+     * The type is one of <code>string</code> (the default), <code>int</code>,
+     * <code>double</code>, <code>bool</code> or <code>json</code>. A placeholder
+     * of type string renders as a quoted JSON string, all other types render
+     * without quotes, e.g.
+     * <pre>
+     * {"id":"${id:int}","name":"${name}","tags":"${tags:json}"}
+     * </pre>
+     * The skeleton is parsed once into a sequence of literal runs and typed slots.
+     * Rendering copies the literal runs and formats only the slot values, no parse
+     * tree is built. The unformatted output is identical to JSON::toString() of the
+     * equivalent document.
+     * <p>
+     * A placeholder name used more than once refers to the same slot.
+     */
+    class Template
+    {
+    public:
+        enum SlotType
+        {
+            TSTRING = 0,
+            TINTEGER,
+            TDOUBLE,
+            TBOOLEAN,
+            TJSON
+        };
+
+        /**
+         * The values to substitute for the slots of a template.
+         * <p>
+         * A Values object may be reused for any number of renderings,
+         * it remains bound to the template it was created for.
+         */
+        class Values
+        {
+            friend class Template;
+
+            struct Value
+            {
+                bool isSet;
+                std::int64_t integer;
+                double number;
+                bool boolean;
+                std::string text;
+
+                Value() : isSet(false), integer(0), number(0), boolean(false) {}
+            };
+
+            const Template& m_template;
+            std::vector<Value> m_values;
+
+            Value& slot(int index, SlotType type);
+
+        public:
+            /**
+             * @param tpl template the values are for
+             */
+            explicit Values(const Template& tpl);
+
+            /**
+             * @brief set a boolean slot
+             *
+             * @param name of slot
+             * @param value boolean
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, bool value);
+
+            /**
+             * @brief set a boolean slot
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value boolean
+             * @return a reference to this object
+             */
+            Values& set(int index, bool value);
+
+            /**
+             * @brief set a double slot
+             *
+             * @param name of slot
+             * @param value double number
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, double value);
+
+            /**
+             * @brief set a double slot
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value double number
+             * @return a reference to this object
+             */
+            Values& set(int index, double value);
+
+            /**
+             * @brief set an integer or double slot
+             *
+             * @param name of slot
+             * @param value integer number
+             * @return a reference to this object
+             */
+            template<typename INTTYPE>
+            typename std::enable_if<std::is_integral<INTTYPE>::value, Values&>::type
+            set(const std::string& name, INTTYPE value)
+            {
+                return set(m_template.slot(name), value);
+            }
+
+            /**
+             * @brief set an integer or double slot
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value integer number
+             * @return a reference to this object
+             */
+            template<typename INTTYPE>
+            typename std::enable_if<std::is_integral<INTTYPE>::value, Values&>::type
+            set(int index, INTTYPE value)
+            {
+                Value& v = slot(index, TINTEGER);
+                v.integer = static_cast<std::int64_t>(value);
+                v.number = static_cast<double>(value);
+                return *this;
+            }
+
+            /**
+             * @brief set a string slot, or a json slot to JSON text
+             *
+             * Text set for a json slot is copied to the output verbatim,
+             * it is checked as an untrusted RawJSON and must be valid JSON.
+             *
+             * @param name of slot
+             * @param value UTF-8 string
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, const std::string& value);
+
+            /**
+             * @brief set a string slot, or a json slot to JSON text
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value UTF-8 string
+             * @return a reference to this object
+             */
+            Values& set(int index, const std::string& value);
+
+            /**
+             * @brief convert const char* to string before setting the slot
+             *
+             * Throws an Exception if @a value is NULL.
+             *
+             * @param name of slot
+             * @param value UTF-8 string
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, const char* value);
+
+            /**
+             * @brief convert const char* to string before setting the slot
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value UTF-8 string
+             * @return a reference to this object
+             */
+            Values& set(int index, const char* value);
+
+            /**
+             * @brief set a json slot to a JSON value
+             *
+             * @param name of slot
+             * @param value any JSON value
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, const JSON& value);
+
+            /**
+             * @brief set a json slot to a JSON value
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value any JSON value
+             * @return a reference to this object
+             */
+            Values& set(int index, const JSON& value);
+
+            /**
+             * @brief set a json slot to pre-serialized JSON
+             *
+             * @param name of slot
+             * @param value serialized JSON value
+             * @return a reference to this object
+             */
+            Values& set(const std::string& name, const RawJSON& value);
+
+            /**
+             * @brief set a json slot to pre-serialized JSON
+             *
+             * @param index of slot @see Template::slot(const std::string&)
+             * @param value serialized JSON value
+             * @return a reference to this object
+             */
+            Values& set(int index, const RawJSON& value);
+
+            /**
+             * @brief forget all values so the object can be refilled
+             */
+            void clear();
+        };
+
+    private:
+        struct Slot
+        {
+            std::string name;
+            SlotType type;
+        };
+
+        /**
+         * A literal run of m_text followed by a slot, or -1 for the final run
+         */
+        struct Part
+        {
+            std::size_t length;
+            int slot;
+        };
+
+        std::string m_text;
+        std::vector<Part> m_parts;
+        std::vector<Slot> m_slots;
+        std::map<std::string, int> m_names;
+
+        /**
+         * Append the skeleton item to m_text, closing a literal run at each placeholder
+         *
+         * @param item of the parsed skeleton
+         * @param mark offset in m_text where the current literal run starts
+         */
+        void compile(const cJSON* item, std::size_t& mark);
+
+        /**
+         * Add a slot if the string item is a placeholder
+         *
+         * @return true if the item is a placeholder
+         */
+        bool placeholder(const cJSON* item, std::size_t& mark);
+
+    public:
+        /**
+         * Compile a template from a JSON skeleton
+         *
+         * @param skeleton JSON formatted UTF-8 string containing placeholders
+         */
+        explicit Template(const std::string& skeleton);
+
+        /**
+         * @return number of distinct slots in the template
+         */
+        std::size_t slots() const;
+
+        /**
+         * @brief get the index of a named slot
+         *
+         * Resolve a slot name once and use the index to set values
+         * on a hot path. Throws an Exception if there is no such slot.
+         *
+         * @param name of placeholder
+         * @return index of slot
+         */
+        int slot(const std::string& name) const;
+
+        /**
+         * @param index of slot
+         * @return type of slot
+         */
+        SlotType getType(int index) const;
+
+        /**
+         * @brief render the template with @a values appending to @a out
+         *
+         * Throws an Exception if any slot has not been set.
+         *
+         * @param values for the slots
+         * @param out the compressed JSON is appended to this string
+         */
+        void render(const Values& values, std::string& out) const;
+
+        /**
+         * @brief render the template with @a values
+         *
+         * @param values for the slots
+         * @return a compressed JSON UTF8 string
+         */
+        std::string render(const Values& values) const;
+    };
+
+} /* namespace JSON */
+#endif /* JSON__TEMPLATE_H_ */
@@ -0,0 +1,120 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef JSON__WRITER_H_
+#define JSON__WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace JSON
+{
+
+    /**
+     * Append JSON tokens to a string buffer.
+     * <p>
+     * Strings are escaped and numbers are formatted exactly as the cJSON printer
+     * does, so text assembled with a Writer is identical to the output of
+     * JSON::toString() for the same values. No parse tree is built.
+     */
+    class Writer
+    {
+        std::string& m_out;
+
+        Writer(const Writer& other);
+        Writer& operator=(const Writer& rhs);
+
+    public:
+        /**
+         * @param out buffer the tokens are appended to
+         */
+        explicit Writer(std::string& out);
+
+        /**
+         * Append @a length bytes of already formatted JSON text verbatim
+         *
+         * @param text JSON text
+         * @param length of text in bytes
+         * @return a reference to this writer
+         */
+        Writer& raw(const char* text, std::size_t length);
+
+        /**
+         * Append a quoted and escaped JSON string
+         *
+         * @param value UTF-8 string
+         * @param length of value in bytes
+         * @return a reference to this writer
+         */
+        Writer& string(const char* value, std::size_t length);
+
+        /**
+         * Append a quoted and escaped JSON string
+         *
+         * @param value UTF-8 string
+         * @return a reference to this writer
+         */
+        Writer& string(const std::string& value)
+        {
+            return string(value.data(), value.size());
+        }
+
+        /**
+         * Append a JSON number from a double, or null for NaN and infinity
+         *
+         * @param value number
+         * @return a reference to this writer
+         */
+        Writer& number(double value);
+
+        /**
+         * Append a JSON number from an integer, all 64 bits are preserved
+         *
+         * @param value number
+         * @return a reference to this writer
+         */
+        Writer& number(std::int64_t value);
+
+        /**
+         * Append JSON true or false
+         *
+         * @param value boolean
+         * @return a reference to this writer
+         */
+        Writer& boolean(bool value);
+
+        /**
+         * Append JSON null
+         *
+         * @return a reference to this writer
+         */
+        Writer& null();
+    };
+
+} /* namespace JSON */
+#endif /* JSON__WRITER_H_ */
@@ -39,8 +39,23 @@ extern "C"
 #define cJSON_String 4
 #define cJSON_Array 5
 #define cJSON_Object 6
+#define cJSON_Raw 7		/* valuestring holds pre-serialized JSON text, printed verbatim */
 
 #define cJSON_IsReference 256
+#define cJSON_IsFrozen 512		/* node of a tree made by cJSON_Freeze, its children cannot be changed */
+#define cJSON_IsPacked 1024		/* array whose numbers are held together in valuestring, see cJSON_GetChild */
+#define cJSON_StringIsInline 2048	/* string points at the storage of the value field the type leaves unused: valuestring of a
+									   number, valueint of an array or object, valuedouble of anything else */
+#define cJSON_ValueIsInline 4096	/* valuestring points at the storage of valueint, its last byte the length */
+
+#define cJSON_IsInteger 8192		/* compact number held in value.integer */
+#define cJSON_StringIsInterned 16384	/* string is an interned key shared with other items, see cJSON_InternKeys */
+
+/* Keys shorter than this, and value strings shorter by one more byte, are kept inside their node instead of in their own
+allocation. A key and a value are inlined independently. */
+#define cJSON_INLINE_STRING 8
+
+struct cJSON_Index;
 
 /* The cJSON structure: */
 typedef struct cJSON {
@@ -48,10 +63,15 @@ typedef struct cJSON {
 	struct cJSON *child;		/* An array or object item will have a child pointer pointing to a chain of the items in the array/object. */
 
 	int type;					/* The type of the item, as above. */
+	unsigned int keylen;		/* Length of string. Maintained by cJSON whenever it sets string, left 0 by code setting string itself, see cJSON_Rekey. */
 
 	char *valuestring;			/* The item's string, if type==cJSON_String */
-	int64_t valueint;				/* The item's number, if type==cJSON_Number */
-	double valuedouble;			/* The item's number, if type==cJSON_Number */
+	int64_t valueint;				/* The item's number, if type==cJSON_Number. The length of valuestring, see cJSON_GetStringLength */
+	union {
+		double valuedouble;			/* The item's number, if type==cJSON_Number */
+		struct cJSON_Index *index;	/* Child count, position and key index of a large array or object, built on demand and kept
+									   current by the cJSON functions that change children. Private to cJSON. */
+	};
 	char *string;				/* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
 } cJSON;
 
@@ -72,6 +92,8 @@ extern void (*cJSON_free)(void *ptr);
 
 /* Supply a block of JSON, and this returns a cJSON object you can interrogate. Call cJSON_Delete when finished. */
 extern cJSON *cJSON_Parse(const char *value);
+/* Parse like cJSON_Parse, packing arrays of many numbers, see cJSON_GetChild. */
+extern cJSON *cJSON_ParsePacked(const char *value);
 /* Render a cJSON entity to text for transfer/storage. Free the char* when finished. */
 extern char  *cJSON_Print(cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. Free the char* when finished. */
@@ -79,12 +101,43 @@ extern char  *cJSON_PrintUnformatted(cJSON *item);
 /* Delete a cJSON entity and all subentities. */
 extern void   cJSON_Delete(cJSON *c);
 
-/* Returns the number of items in an array (or object). */
+/* The getters below may be called from several threads at once on a tree that nothing is modifying. */
+/* Returns the number of items in an array (or object). Counted once for a large array, then kept. */
 extern int	  cJSON_GetArraySize(cJSON *array);
-/* Retrieve item number "item" from array "array". Returns NULL if unsuccessful. */
+/* Retrieve item number "item" from array "array". Returns NULL if unsuccessful. Constant time for sequential or random access. */
 extern cJSON *cJSON_GetArrayItem(cJSON *array,int item);
+/* First child of an array or object. Arrays of many numbers from cJSON_ParsePacked and cJSON_CreatePacked*Array are
+packed: their numbers are held together, ->child is NULL and nodes are made for them, once, when this or
+cJSON_GetArrayItem first needs them. Walk the ->child of such trees only from here. No other function packs an array. */
+extern cJSON *cJSON_GetChild(cJSON *item);
+/* Copy number "item" of a packed array whose nodes have not been made to *valuedouble and *valueint, either may be
+NULL. Returns 1, or 0 if array is not such an array or item is out of range. */
+extern int cJSON_GetPackedItem(cJSON *array,int item,double *valuedouble,int64_t *valueint);
+/* Copy up to count numbers of array, from number "start" on, to numbers as valuedouble or valueint. Returns the number
+copied, fewer than count at the end of the array or at an element that is not a number. A packed array is copied from
+its values without making nodes. */
+extern int cJSON_GetDoubleArray(cJSON *array,int start,double *numbers,int count);
+extern int cJSON_GetInt64Array(cJSON *array,int start,int64_t *numbers,int count);
+/* Name item string, or unname it if string is NULL. Returns 0 without memory. Used for items about to join an object. */
+extern int cJSON_SetItemKey(cJSON *item,const char *string);
+/* Byte length of the key of item, also when its ->string was set by hand. 0 for an item without a key. */
+extern size_t cJSON_GetKeyLength(const cJSON *item);
+/* A key set by hand, with keylen left 0, is still found by its text. Call this on item after changing
+->string of any key cJSON had set, or relinking ->child and ->next lists, by hand: it recomputes the key lengths and prev
+links of item and everything below it and drops their indexes, which would otherwise miss or return stale members.
+Frozen trees are left alone. */
+extern void cJSON_Rekey(cJSON *item);
+/* Byte length of the valuestring of a String or Raw item, which may hold NUL bytes from \u0000 escapes. 0 for other items. */
+extern size_t cJSON_GetStringLength(const cJSON *item);
+/* Keys too long to be kept in their node are interned: the parser shares one copy of each among the members of a
+document. With enable set, keys this thread gives items, through cJSON_AddItemToObject and the like, and keys parsed by
+it are also interned, across documents, until it calls this again with enable 0 or ends. Returns 0 without memory.
+Interned keys are reference counted, so trees may be deleted in any order and on any thread. */
+extern int cJSON_InternKeys(int enable);
 /* Get item "string" from object. Case insensitive. */
 extern cJSON *cJSON_GetObjectItem(cJSON *object,const char *string);
+/* Get item "string" from object. Exact match. */
+extern cJSON *cJSON_GetObjectItemCaseSensitive(cJSON *object,const char *string);
 
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 extern const char *cJSON_GetErrorPtr(void);
@@ -96,8 +149,12 @@ extern cJSON *cJSON_CreateFalse(void);
 extern cJSON *cJSON_CreateBool(int b);
 extern cJSON *cJSON_CreateNumber(double num);
 extern cJSON *cJSON_CreateString(const char *string);
+/* Create a string of length bytes, which may include NUL. */
+extern cJSON *cJSON_CreateStringWithLength(const char *string,size_t length);
 extern cJSON *cJSON_CreateArray(void);
 extern cJSON *cJSON_CreateObject(void);
+/* Create an item holding already serialized JSON text. The text is not checked, see cJSON_Validate. */
+extern cJSON *cJSON_CreateRaw(const char *raw);
 
 /* These utilities create an Array of count items. */
 extern cJSON *cJSON_CreateIntArray(int *numbers,int count);
@@ -105,9 +162,16 @@ extern cJSON *cJSON_CreateInt64Array(int64_t *numbers,int count);
 extern cJSON *cJSON_CreateFloatArray(float *numbers,int count);
 extern cJSON *cJSON_CreateDoubleArray(double *numbers,int count);
 extern cJSON *cJSON_CreateStringArray(const char **strings,int count);
+/* Create a packed array of count numbers, see cJSON_GetChild; an ordinary one if count is small. */
+extern cJSON *cJSON_CreatePackedIntArray(int *numbers,int count);
+extern cJSON *cJSON_CreatePackedInt64Array(int64_t *numbers,int count);
+extern cJSON *cJSON_CreatePackedFloatArray(float *numbers,int count);
+extern cJSON *cJSON_CreatePackedDoubleArray(double *numbers,int count);
 
-/* Append item to the specified array/object. */
+/* Append item to the specified array/object. A packed array is turned into nodes first. */
 extern void cJSON_AddItemToArray(cJSON *array, cJSON *item);
+/* Append a number to array, into the values of a packed array if they can hold it. Returns 0 without memory. */
+extern int cJSON_AddNumberToArray(cJSON *array,double num);
 extern void	cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item);
 /* Append reference to item to the specified array/object. Use this when you want to add an existing cJSON to a new cJSON, but don't want to corrupt your existing cJSON. */
 extern void cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
@@ -118,10 +182,16 @@ extern cJSON *cJSON_DetachItemFromArray(cJSON *array,int which);
 extern void   cJSON_DeleteItemFromArray(cJSON *array,int which);
 extern cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string);
 extern void   cJSON_DeleteItemFromObject(cJSON *object,const char *string);
+extern cJSON *cJSON_DetachItemFromObjectCaseSensitive(cJSON *object,const char *string);
+extern void   cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object,const char *string);
 
 /* Update array items. */
 extern void cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem);
 extern void cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem);
+extern void cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem);
+/* Replace item "string" in object with newitem, or add newitem if there is none. Costs one lookup. */
+extern void cJSON_SetItemInObject(cJSON *object,const char *string,cJSON *newitem);
+extern void cJSON_SetItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem);
 
 /* Duplicate a cJSON item */
 extern cJSON *cJSON_Duplicate(cJSON *item,int recurse);
@@ -129,9 +199,97 @@ extern cJSON *cJSON_Duplicate(cJSON *item,int recurse);
 need to be released. With recurse!=0, it will duplicate any children connected to the item.
 The item->next and ->prev pointers are always zero on return from Duplicate. */
 
+/* Copy item into a single allocation: the nodes in depth first order, large arrays and objects indexed, then the
+keys and strings. The copy reads like any other tree and is released with cJSON_Delete, but adding, detaching or
+replacing its children does nothing. A frozen tree may itself be added to a tree that is not frozen. */
+extern cJSON *cJSON_Freeze(cJSON *item);
+
+/* Write item as a frozen tree whose pointers are offsets from the start of the image, ready to be saved to a file.
+Returns the image, to be released with cJSON_free, and sets *size to its length. */
+extern void *cJSON_Snapshot(cJSON *item,size_t *size);
+/* How many bytes from the start of the snapshot in image cJSON_LoadSnapshot and readers of the tree write: the header,
+nodes, indexes and tables. The keys and strings after them are only read. 0 if image is no snapshot of this build. */
+extern size_t cJSON_SnapshotWritable(const void *image,size_t size);
+/* Load the snapshot in image, an 8 byte aligned copy of the file such as a private mapping whose first
+cJSON_SnapshotWritable bytes are writable, and return its root, frozen, or 0 if image is not a snapshot written by
+this build. The offsets are turned into pointers in place. cJSON_Delete of the root calls release, if not 0, with
+image and size. Every pointer is checked to land in its part of the image, and every string to end in it, so loading
+reads every node and takes time in proportion to the tree; one that fails is returned 0, possibly rewritten. */
+extern cJSON *cJSON_LoadSnapshot(void *image,size_t size,void (*release)(void *image,size_t size));
+
+/* Returns 1 if a and b hold the same JSON, 0 at the first difference found. Numbers compare by value, object members by
+exact key, in any order unless ordered is non-zero; members under a duplicated key must then be as many and hold the
+same values on both sides. Allocates nothing, except that a lookup may index a large object. */
+extern int cJSON_Compare(cJSON *a,cJSON *b,int ordered);
+
+/* Seeded 64 bit hash of the tree, equal for trees that cJSON_Compare finds equal with the same ordered flag.
+A frozen tree keeps its hash for good and is hashed again in constant time. Nodes have no parent links, so in a tree
+that can change every array or object holding arrays or objects is hashed again from its children on each call; only
+large arrays and objects of plain values keep their hash, dropped when their own children are added, detached or
+replaced through this API. Change no values or keys in place after hashing. */
+extern uint64_t cJSON_Hash(cJSON *item,uint64_t seed,int ordered);
+
+/* Frozen copy of item with identical subtrees stored once. An array, object or heap string equal to one met before it,
+depth first, becomes a cJSON_IsReference node sharing that node's children or text. Numbers must match bit for bit and
+members in order and case. item is not changed. If saved is not 0 it is set to how many bytes smaller the block is
+than cJSON_Freeze(item) would make it. cJSON_Snapshot keeps the sharing. Release with cJSON_Delete; returns 0 without memory. */
+extern cJSON *cJSON_Dedupe(cJSON *item,size_t *saved);
+
+/* A compact, read only copy of a tree in a single allocation. Nodes are 24 bytes and hold no pointers: the children of
+an array or object are consecutive nodes, found by index, and keys and strings are offsets into a pool of text that
+follows the nodes. Objects with the same keys in the same order share one shape, which holds their keys once and a
+table from key to position, so a member is found without scanning. See cJSON_CompactTree. */
+typedef struct cJSON_Compact {uint32_t nodes,shapes,words,pool;} cJSON_Compact;
+typedef struct cJSON_CompactNode {
+	int type;					/* cJSON type, with cJSON_IsInteger for a number in value.integer */
+	uint32_t key;				/* Offset of the key in the pool, 0 for none */
+	uint32_t child;				/* Index of the first child of an array or object */
+	uint32_t count;				/* Number of children, or length of a string */
+	union {double number;int64_t integer;uint32_t string;uint32_t shape;} value;	/* string: offset of a String or Raw in the pool;
+																	shape: offset of an object's shape in the shape words, 0 for none */
+} cJSON_CompactNode;
+/* The shape and position of a member found by cJSON_CompactObjectItemSlot. Start it zeroed. */
+typedef struct cJSON_CompactSlot {uint32_t shape,position;} cJSON_CompactSlot;
+
+/* Copy item into a compact document, released with cJSON_DeleteCompact, or 0 without memory or beyond 2^32 nodes or
+bytes of text. Packed arrays are copied from their values. ParseCompact parses value and compacts the tree. */
+extern cJSON_Compact *cJSON_CompactTree(cJSON *item);
+extern cJSON_Compact *cJSON_ParseCompact(const char *value);
+extern void cJSON_DeleteCompact(cJSON_Compact *doc);
+/* Bytes held by doc. */
+extern size_t cJSON_CompactSize(const cJSON_Compact *doc);
+/* The root node of doc. */
+extern const cJSON_CompactNode *cJSON_CompactRoot(const cJSON_Compact *doc);
+/* Child number "item" of an array or object node, in constant time. NULL if out of range. */
+extern const cJSON_CompactNode *cJSON_CompactItem(const cJSON_Compact *doc,const cJSON_CompactNode *node,int item);
+/* Member "string" of an object node, case insensitive or exact as for cJSON_GetObjectItem, looked up in its shape. */
+extern const cJSON_CompactNode *cJSON_CompactObjectItem(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string);
+extern const cJSON_CompactNode *cJSON_CompactObjectItemCaseSensitive(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string);
+/* As cJSON_CompactObjectItem, remembering the shape and the member's position in slot. An object of the same shape, such as
+the next record of an array, then finds the member by that position without looking at the key. */
+extern const cJSON_CompactNode *cJSON_CompactObjectItemSlot(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string,cJSON_CompactSlot *slot);
+/* Number of distinct object shapes in doc. */
+extern size_t cJSON_CompactShapes(const cJSON_Compact *doc);
+/* Key of node, NULL for none; text of a String or Raw node, NULL for other types. */
+extern const char *cJSON_CompactKey(const cJSON_Compact *doc,const cJSON_CompactNode *node);
+extern const char *cJSON_CompactString(const cJSON_Compact *doc,const cJSON_CompactNode *node);
+/* The number as valuedouble and valueint would hold it. */
+extern double cJSON_CompactDouble(const cJSON_CompactNode *node);
+extern int64_t cJSON_CompactInt64(const cJSON_CompactNode *node);
+/* Build node and its children as a cJSON tree, without a key, for cJSON_Delete. */
+extern cJSON *cJSON_CompactExpand(const cJSON_Compact *doc,const cJSON_CompactNode *node);
+
 /* ParseWithOpts allows you to require (and check) that the JSON is null terminated, and to retrieve the pointer to the final byte parsed. */
 extern cJSON *cJSON_ParseWithOpts(const char *value,const char **return_parse_end,int require_null_terminated);
 
+/* Check that value is a single, null terminated JSON value without building a tree. Returns 1 if valid, 0 if not. */
+extern int cJSON_Validate(const char *value);
+
+/* Scan the JSON number at num into *value exactly as the parser does, and unless integer is NULL into *integer: exact
+for integers of up to 18 digits, otherwise the value truncated, 0 if out of range. Returns the text after the number,
+or NULL if num does not start with one. No node is made. */
+extern const char *cJSON_ScanNumber(const char *num,double *value,int64_t *integer);
+
 /* Macros for creating things quickly. */
 #define cJSON_AddNullToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateNull())
 #define cJSON_AddTrueToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateTrue())
@@ -38,8 +38,19 @@ namespace JSON
         return *this;
     }
 
+    /**
+     * The what() text, built before the members are, m_oss among them
+     */
+    static string
+    describe(const string& name, const string& file, int line, const string& method, const string& message)
+    {
+        ostringstream oss;
+        oss << name << " thrown by: " << method << " (" << file << ":" << line << ") " << message << endl;
+        return oss.str();
+    }
+
     Exception::Exception(const string& name, const string& file, int line, const string& method, const string& message) throw()
-        : runtime_error(((ostringstream&)(m_oss << name << " thrown by: " << method << " (" << file << ":" << line << ") " << message << endl)).str())
+        : runtime_error(describe(name, file, line, method, message))
         , m_name(name)
         , m_file(file)
         , m_line(line)
@@ -24,8 +24,10 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
-#include <cassert>
+#include <climits>
+
 #include <JSON/JSON.h>
+#include <JSON/Iterator.h>
 
 namespace JSON
 {
@@ -34,11 +36,9 @@ namespace JSON
 
     JSON::JSON(bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(cJSON_CreateNull())
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(cJSON_CreateNull())
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         JLOG("constructed with cJSON_CreateNull");
@@ -46,11 +46,9 @@ namespace JSON
 
     JSON::JSON(bool val, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(cJSON_CreateBool(val))
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(cJSON_CreateBool(val))
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         JLOG("constructed with cJSON_CreateBool");
@@ -58,11 +56,9 @@ namespace JSON
 
     JSON::JSON(double val, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(cJSON_CreateNumber(val))
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(cJSON_CreateNumber(val))
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         JLOG("constructed with cJSON_CreateNumber");
@@ -70,11 +66,9 @@ namespace JSON
 
     JSON::JSON(Type type, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(0)
+        , m_caseSensitive(false)
         , m_node(0)
+        , m_doc(0)
     {
         JTRACE;
         switch(type)
@@ -86,41 +80,39 @@ namespace JSON
             break;
         case JARRAY:
             JLOG("constructed with cJSON_CreateArray");
-            m_root = cJSON_CreateArray();
+            m_node = cJSON_CreateArray();
             break;
         case JOBJECT:
             JLOG("constructed with cJSON_CreateObject");
-            m_root = cJSON_CreateObject();
+            m_node = cJSON_CreateObject();
             break;
         case JBOOLEAN:
             JLOG("constructed with cJSON_CreateBool");
-            m_root = cJSON_CreateBool(false);
+            m_node = cJSON_CreateBool(false);
             break;
         case JSTRING:
             JLOG("constructed with cJSON_CreateString");
-            m_root = cJSON_CreateString("");
+            m_node = cJSON_CreateString("");
             break;
         case JNUMBER:
             JLOG("constructed with cJSON_CreateNumber");
-            m_root = cJSON_CreateNumber(0);
+            m_node = cJSON_CreateNumber(0);
             break;
         case JNULL:
             JLOG("constructed with cJSON_CreateNull");
-            m_root = cJSON_CreateNull();
+            m_node = cJSON_CreateNull();
             break;
         default:
             THROW_MSG(Exception, "unexpected type for this constructor");
         }
-        m_node = m_root;
+        m_doc = Document::create(m_node);
     }
 
     JSON::JSON(const string& val, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(val.empty() ? cJSON_CreateNull() : cJSON_Parse(val.c_str()))
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(val.empty() ? cJSON_CreateNull() : cJSON_Parse(val.c_str()))
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         /*
@@ -128,7 +120,7 @@ namespace JSON
          * const char* ep in cJSON.c - therefore it is not thread safe, we will ignore this
          * function.
          */
-        if(0 == m_root)
+        if(0 == m_node)
             THROW_MSG(Exception, "parse error: " << val);
 
         JLOG("constructed with cJSON_Parse");
@@ -136,11 +128,9 @@ namespace JSON
 
     JSON::JSON(const char* val, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(val == NULL || *val == '\0' ? cJSON_CreateNull() : cJSON_Parse(val))
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(val == NULL || *val == '\0' ? cJSON_CreateNull() : cJSON_Parse(val))
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         /*
@@ -148,7 +138,7 @@ namespace JSON
          * const char* ep in cJSON.c - therefore it is not thread safe, we will ignore this
          * function.
          */
-        if(0 == m_root)
+        if(0 == m_node)
             THROW_MSG(Exception, "parse error: " << val);
 
         JLOG("constructed with cJSON_Parse");
@@ -156,11 +146,9 @@ namespace JSON
 
     JSON::JSON(char* val, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(val == NULL || *val == '\0' ? cJSON_CreateNull() : cJSON_Parse(val))
-        , m_node(m_root)
+        , m_caseSensitive(false)
+        , m_node(val == NULL || *val == '\0' ? cJSON_CreateNull() : cJSON_Parse(val))
+        , m_doc(Document::create(m_node))
     {
         JTRACE;
         /*
@@ -168,7 +156,7 @@ namespace JSON
          * const char* ep in cJSON.c - therefore it is not thread safe, we will ignore this
          * function.
          */
-        if(0 == m_root)
+        if(0 == m_node)
             THROW_MSG(Exception, "parse error: " << val);
 
         JLOG("constructed with cJSON_Parse");
@@ -177,9 +165,9 @@ namespace JSON
 
     JSON::JSON(istream& is, bool trace)
         : m_trace(trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
+        , m_caseSensitive(false)
+        , m_node(0)
+        , m_doc(0)
     {
         /*
          * read in the string and parse, we don't assume
@@ -191,93 +179,88 @@ namespace JSON
         while (is.read(buf, sizeof(buf)))
             val.append(buf, sizeof(buf));
         val.append(buf, is.gcount());
-        m_root = val.empty() ? cJSON_CreateNull() : cJSON_Parse(val.c_str());
-        m_node = m_root;
+        own(val.empty() ? cJSON_CreateNull() : cJSON_Parse(val.c_str()));
     }
 
     JSON::JSON(const JSON& other)
         : m_trace(other.m_trace)
-        , m_next(0)
-        , m_prev(0)
-        , m_self(this)
-        , m_root(0)
+        , m_caseSensitive(other.m_caseSensitive)
+        , m_node(other.m_node)
+        , m_doc(other.m_doc)
+    {
+        JTRACE;
+
+        if(m_doc)
+            m_doc->retain();
+    }
+
+    JSON::JSON(JSON&& other) noexcept
+        : m_trace(other.m_trace)
+        , m_caseSensitive(other.m_caseSensitive)
         , m_node(other.m_node)
+        , m_doc(other.m_doc)
     {
         JTRACE;
 
-        addSelf(&other);
+        other.m_node = 0;
+        other.m_doc = 0;
     }
 
     JSON::~JSON()
     {
         JTRACE;
 
-        removeSelf();
+        detach();
     }
 
     void
-    JSON::addSelf(const JSON* node) const
+    JSON::attach(Document* doc, cJSON* node) noexcept
     {
         JTRACE;
 
         /*
-         * insert in chain after node
+         * retain before release, doc may be the document already referenced
          */
-        m_self->m_next = node->m_next;
-        m_self->m_prev = node->m_self;
-
-        m_prev->m_next = this->m_self;
-        if(m_next)
-            m_next->m_prev = this->m_self;
+        if(doc)
+            doc->retain();
+        if(m_doc)
+            m_doc->release();
+        m_doc = doc;
+        m_node = node;
     }
 
     void
-    JSON::removeSelf()
+    JSON::detach() noexcept
     {
         JTRACE;
 
-        if(m_root)
-        {
-            /*
-             * Only the head node can own a parse tree
-             */
-            assert(m_prev == 0);
-
-            if(m_next)
-            {
-                m_next->m_root = m_root;
-                m_next->m_prev = 0;
-            }
-            else
-            {
-                JLOG("calling cJSON_Delete");
-                cJSON_Delete(m_root);
-            }
-            m_root = 0;
-        }
-        else
-        {
-            if(m_next)
-                m_next->m_prev = m_prev;
-            if(m_prev)
-                m_prev->m_next = m_next;
-        }
-        m_next = 0;
-        m_prev = 0;
+        if(m_doc)
+            m_doc->release();
+        m_doc = 0;
         m_node = 0;
     }
 
     void
-    JSON::parse(const char* json)
+    JSON::own(cJSON* root)
     {
         JTRACE;
 
-        if(m_node)
-            removeSelf();
+        detach();
+        m_doc = Document::create(root);
+        m_node = root;
+    }
 
-        JLOG("calling cJSON_Parse");
-        m_root = cJSON_Parse(json);
-        m_node = m_root;
+    void
+    JSON::parse(const char* json, bool packed)
+    {
+        JTRACE;
+
+        JLOG(packed ? "calling cJSON_ParsePacked" : "calling cJSON_Parse");
+        cJSON* root = packed ? cJSON_ParsePacked(json) : cJSON_Parse(json);
+        if(0 == root)
+            THROW_MSG(Exception, "parse error: " << json);
+
+        own(root);
     }
 
     cJSON*
@@ -288,19 +271,16 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
-        cJSON *elem = cJSON_GetObjectItem(m_node, key.c_str());;
+        cJSON *elem = m_caseSensitive ? cJSON_GetObjectItemCaseSensitive(m_node, key.c_str())
+                                      : cJSON_GetObjectItem(m_node, key.c_str());
         if(0 == elem && !optional)
             THROW_MSG(Exception, "mandatory JSON object element missing: " << key);
 
-        if(copy)
-        {
-            char* json = cJSON_PrintUnformatted(elem);
-            elem = cJSON_Parse(json);
-            cJSON_free(json);
-        }
+        if(copy && elem)
+            elem = duplicate(elem);
         return elem;
     }
 
@@ -312,20 +292,125 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON *elem = cJSON_GetArrayItem(m_node, index);
         if(0 == elem && !optional)
             THROW_MSG(Exception, "mandatory JSON array index missing: " << index);
 
-        if(copy)
+        if(copy && elem)
+            elem = duplicate(elem);
+        return elem;
+    }
+
+    cJSON*
+    JSON::duplicate(cJSON* elem)
+    {
+        cJSON* tree = cJSON_Duplicate(elem, 1);
+        if(0 == tree)
+            THROW_MSG(Exception, "out of memory copying JSON element");
+
+        /*
+         * the copy is the root of its own tree, it is nobody's member
+         */
+        cJSON_SetItemKey(tree, 0);
+        return tree;
+    }
+
+    void
+    JSON::replaceElement(const string& key, cJSON* elem)
+    {
+        JTRACE;
+
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
+
+        if(m_caseSensitive)
+            cJSON_ReplaceItemInObjectCaseSensitive(m_node, key.c_str(), elem);
+        else
+            cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+
+        // cJSON names the element before linking it, so an unnamed element is
+        // not in the tree: either no item had the key or the key could not be copied
+        if(0 == elem->string)
         {
-            char* json = cJSON_PrintUnformatted(elem);
-            elem = cJSON_Parse(json);
-            cJSON_free(json);
+            cJSON* item = m_caseSensitive ? cJSON_GetObjectItemCaseSensitive(m_node, key.c_str()) : cJSON_GetObjectItem(m_node, key.c_str());
+            cJSON_Delete(elem);
+            if(item)
+                THROW_MSG(Exception, "no memory while naming JSON object element: {\"" << key << "\"}");
         }
-        return elem;
+    }
+
+    void
+    JSON::setItem(const string& key, cJSON* elem)
+    {
+        JTRACE;
+
+        if(0 == m_node || (m_node->type & cJSON_IsFrozen) || (m_node->type & 255) != cJSON_Object)
+        {
+            cJSON_Delete(elem);
+            if(0 == m_node)
+                THROW_MSG(Exception, "JSON node NULL");
+            if(m_node->type & cJSON_IsFrozen)
+                THROW_MSG(Exception, "JSON is frozen");
+            THROW_MSG(Exception, "expected JSON object");
+        }
+
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
+
+        if(m_caseSensitive)
+            cJSON_SetItemInObjectCaseSensitive(m_node, key.c_str(), elem);
+        else
+            cJSON_SetItemInObject(m_node, key.c_str(), elem);
+
+        if(0 == elem->string)
+        {
+            cJSON_Delete(elem);
+            THROW_MSG(Exception, "no memory while naming JSON object element: {\"" << key << "\"}");
+        }
+    }
+
+    void
+    JSON::setItem(const string& key, const JSON& value)
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "expected JSON object");
+
+        if(0 == value.m_node)
+            THROW_MSG(Exception, "child JSON node NULL");
+
+        /*
+         * a view into another tree goes in as a copy, an owner hands its tree over
+         */
+        cJSON* elem = value.m_node;
+        bool owned = value.m_doc && value.m_doc->owns(elem);
+        if(!owned)
+            elem = duplicate(elem);
+
+        if(m_caseSensitive)
+            cJSON_SetItemInObjectCaseSensitive(m_node, key.c_str(), elem);
+        else
+            cJSON_SetItemInObject(m_node, key.c_str(), elem);
+
+        // left unlinked, an owner keeps its tree and a copy is dropped
+        if(0 == elem->string)
+        {
+            if(!owned)
+                cJSON_Delete(elem);
+            THROW_MSG(Exception, "no memory while naming JSON object element: {\"" << key << "\"}");
+        }
+        if(owned)
+            value.m_doc->adopt(m_doc);
     }
 
     JSON::Type
@@ -336,7 +421,7 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        switch(m_node->type)
+        switch(m_node->type & 255)
         {
         case cJSON_False:
         case cJSON_True:
@@ -351,6 +436,8 @@ namespace JSON
             return JARRAY;
         case cJSON_Object:
             return JOBJECT;
+        case cJSON_Raw:
+            return JRAW;
         }
         /*
          * shouldn't get here, but all JSON data types are UTF-8 strings
@@ -366,7 +453,7 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON *elem = getItem(key.c_str(), true);
@@ -374,7 +461,7 @@ namespace JSON
         if(0 == elem)
             return JNONE;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_False:
         case cJSON_True:
@@ -389,6 +476,8 @@ namespace JSON
             return JARRAY;
         case cJSON_Object:
             return JOBJECT;
+        case cJSON_Raw:
+            return JRAW;
         }
         /*
          * shouldn't get here, but all JSON data types are UTF-8 strings
@@ -404,7 +493,7 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected ARRAY object");
 
         cJSON *elem = getItem(index, true);
@@ -412,7 +501,7 @@ namespace JSON
         if(0 == elem)
             return JNONE;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_False:
         case cJSON_True:
@@ -427,6 +516,8 @@ namespace JSON
             return JARRAY;
         case cJSON_Object:
             return JOBJECT;
+        case cJSON_Raw:
+            return JRAW;
         }
         /*
          * shouldn't get here, but all JSON data types are UTF-8 strings
@@ -459,7 +550,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key, true);
 
-        return 0 != elem && cJSON_NULL == elem->type;
+        return 0 != elem && cJSON_NULL == (elem->type & 255);
     }
 
     bool
@@ -468,7 +559,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(index, true);
 
-        return 0 != elem && cJSON_NULL == elem->type;
+        return 0 != elem && cJSON_NULL == (elem->type & 255);
     }
 
     bool
@@ -477,7 +568,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_False:
             return false;
@@ -495,7 +586,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return elem->valuedouble;
@@ -511,7 +602,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return (long)elem->valueint;
@@ -527,10 +618,10 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_String:
-            return elem->valuestring;
+            return string(elem->valuestring, cJSON_GetStringLength(elem));
         }
         char* json = cJSON_PrintUnformatted(elem);
         string jsonstring = json;
@@ -544,7 +635,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key, false, copy);
 
-        if(elem->type != cJSON_Array)
+        if((elem->type & 255) != cJSON_Array)
         {
             if(copy)
                 cJSON_Delete(elem);
@@ -552,12 +643,10 @@ namespace JSON
             THROW_MSG(Exception, "JSON element is not an array: {\"" << key << "\"}");
         }
 
-        value.removeSelf();
-        value.m_node = elem;
         if(copy)
-            value.m_root = elem;
+            value.own(elem);
         else
-            value.addSelf(this);
+            value.attach(m_doc, elem);
     }
 
     void
@@ -566,7 +655,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(key, false, copy);
 
-        if(elem->type != cJSON_Object)
+        if((elem->type & 255) != cJSON_Object)
         {
             if(copy)
                 cJSON_Delete(elem);
@@ -574,12 +663,10 @@ namespace JSON
             THROW_MSG(Exception, "JSON element is not an object: {\"" << key << "\"}");
         }
 
-        value.removeSelf();
-        value.m_node = elem;
         if(copy)
-            value.m_root = elem;
+            value.own(elem);
         else
-            value.addSelf(this);
+            value.attach(m_doc, elem);
     }
 
     bool
@@ -590,7 +677,7 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_True:
             return true;
@@ -608,7 +695,7 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return elem->valuedouble;
@@ -624,7 +711,7 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return (long)elem->valueint;
@@ -640,10 +727,10 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_String:
-            return elem->valuestring;
+            return string(elem->valuestring, cJSON_GetStringLength(elem));
         }
         char* json = cJSON_PrintUnformatted(elem);
         string jsonstring = json;
@@ -655,20 +742,14 @@ namespace JSON
     JSON::optJSONArray(const std::string& key, JSON& value, bool copy) const
     {
         JTRACE;
-        cJSON *elem = getItem(key, true, copy);
-        if(0 != elem)
+        cJSON *elem = getItem(key, true);
+        if(0 != elem && (elem->type & 255) == cJSON_Array)
         {
-            switch(elem->type)
-            {
-            case cJSON_Array:
-                value.removeSelf();
-                value.m_node = elem;
-                if(copy)
-                    value.m_root = elem;
-                else
-                    value.addSelf(this);
-                return true;
-            }
+            if(copy)
+                value.own(duplicate(elem));
+            else
+                value.attach(m_doc, elem);
+            return true;
         }
         return false;
     }
@@ -677,20 +758,14 @@ namespace JSON
     JSON::optJSONObject(const std::string& key, JSON& value, bool copy) const
     {
         JTRACE;
-        cJSON *elem = getItem(key, true, copy);
-        if(0 != elem)
+        cJSON *elem = getItem(key, true);
+        if(0 != elem && (elem->type & 255) == cJSON_Object)
         {
-            switch(elem->type)
-            {
-            case cJSON_Object:
-                value.removeSelf();
-                value.m_node = elem;
-                if(copy)
-                    value.m_root = elem;
-                else
-                    value.addSelf(this);
-                return true;
-            }
+            if(copy)
+                value.own(duplicate(elem));
+            else
+                value.attach(m_doc, elem);
+            return true;
         }
         return false;
     }
@@ -701,7 +776,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(index);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_False:
             return false;
@@ -717,9 +792,15 @@ namespace JSON
     JSON::getDouble(int index) const
     {
         JTRACE;
+
+        // a packed array is read without making nodes for its numbers
+        double value;
+        if(0 != m_node && cJSON_GetPackedItem(m_node, index, &value, 0))
+            return value;
+
         cJSON *elem = getItem(index);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return elem->valuedouble;
@@ -733,9 +814,14 @@ namespace JSON
     JSON::getLong(int index) const
     {
         JTRACE;
+
+        int64_t value;
+        if(0 != m_node && cJSON_GetPackedItem(m_node, index, 0, &value))
+            return (long)value;
+
         cJSON *elem = getItem(index);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return (long)elem->valueint;
@@ -751,10 +837,10 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(index);
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_String:
-            return elem->valuestring;
+            return string(elem->valuestring, cJSON_GetStringLength(elem));
         }
         string strValue;
         char* json = cJSON_PrintUnformatted(elem);
@@ -770,7 +856,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(index, false, copy);
 
-        if(elem->type != cJSON_Array)
+        if((elem->type & 255) != cJSON_Array)
         {
             if(copy)
                 cJSON_Delete(elem);
@@ -778,12 +864,10 @@ namespace JSON
             THROW_MSG(Exception, "JSON element is not an array: [" << index << "]");
         }
 
-        value.removeSelf();
-        value.m_node = elem;
         if(copy)
-            value.m_root = elem;
+            value.own(elem);
         else
-            value.addSelf(this);
+            value.attach(m_doc, elem);
     }
 
     void
@@ -792,7 +876,7 @@ namespace JSON
         JTRACE;
         cJSON *elem = getItem(index, false, copy);
 
-        if(elem->type != cJSON_Object)
+        if((elem->type & 255) != cJSON_Object)
         {
             if(copy)
                 cJSON_Delete(elem);
@@ -800,12 +884,10 @@ namespace JSON
             THROW_MSG(Exception, "JSON element is not an object: [" << index << "]");
         }
 
-        value.removeSelf();
-        value.m_node = elem;
         if(copy)
-            value.m_root = elem;
+            value.own(elem);
         else
-            value.addSelf(this);
+            value.attach(m_doc, elem);
     }
 
     bool
@@ -816,7 +898,7 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_True:
             return true;
@@ -830,11 +912,16 @@ namespace JSON
     JSON::optDouble(int index, double defaultValue) const
     {
         JTRACE;
+
+        double value;
+        if(0 != m_node && cJSON_GetPackedItem(m_node, index, &value, 0))
+            return value;
+
         cJSON *elem = getItem(index, true);
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return elem->valuedouble;
@@ -846,11 +933,16 @@ namespace JSON
     JSON::optLong(int index, long defaultValue) const
     {
         JTRACE;
+
+        int64_t value;
+        if(0 != m_node && cJSON_GetPackedItem(m_node, index, 0, &value))
+            return (long)value;
+
         cJSON *elem = getItem(index, true);
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_Number:
             return (long)elem->valueint;
@@ -866,10 +958,10 @@ namespace JSON
         if(0 == elem)
             return defaultValue;
 
-        switch(elem->type)
+        switch(elem->type & 255)
         {
         case cJSON_String:
-            return elem->valuestring;
+            return string(elem->valuestring, cJSON_GetStringLength(elem));
         }
         char* json = cJSON_PrintUnformatted(elem);
         string jsonstring = json;
@@ -882,22 +974,13 @@ namespace JSON
     {
         JTRACE;
         cJSON *elem = getItem(index, true);
-        if(0 != elem)
+        if(0 != elem && (elem->type & 255) == cJSON_Array)
         {
-            switch(elem->type)
-            {
-            case cJSON_Array:
-                value.removeSelf();
-                value.m_node = elem;
-                if(copy)
-                    value.m_root = elem;
-                else
-                    value.addSelf(this);
-                return true;
-            default:
-                if(copy)
-                    cJSON_Delete(elem);
-            }
+            if(copy)
+                value.own(duplicate(elem));
+            else
+                value.attach(m_doc, elem);
+            return true;
         }
         return false;
     }
@@ -907,22 +990,13 @@ namespace JSON
     {
         JTRACE;
         cJSON *elem = getItem(index, true);
-        if(0 != elem)
+        if(0 != elem && (elem->type & 255) == cJSON_Object)
         {
-            switch(elem->type)
-            {
-            case cJSON_Object:
-                value.removeSelf();
-                value.m_node = elem;
-                if(copy)
-                    value.m_root = elem;
-                else
-                    value.addSelf(this);
-                return true;
-            default:
-                if(copy)
-                    cJSON_Delete(elem);
-            }
+            if(copy)
+                value.own(duplicate(elem));
+            else
+                value.attach(m_doc, elem);
+            return true;
         }
         return false;
     }
@@ -935,7 +1009,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON_AddBoolToObject(m_node, key.c_str(), value);
@@ -949,7 +1026,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON_AddNumberToObject(m_node, key.c_str(), value);
@@ -963,7 +1043,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON_AddNumberToObject(m_node, key.c_str(), value);
@@ -977,10 +1060,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
-        cJSON_AddStringToObject(m_node, key.c_str(), value.c_str());
+        cJSON* elem = cJSON_CreateStringWithLength(value.data(), value.size());
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
+
+        cJSON_AddItemToObject(m_node, key.c_str(), elem);
     }
 
     void
@@ -991,18 +1081,47 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         if(0 == value.m_node)
             THROW_MSG(Exception, "child JSON node NULL");
 
-        if(!value.m_root)
-            THROW_MSG(Exception, "child does not own JSON node");
+        /*
+         * a view into another tree goes in as a copy, an owner hands its tree over
+         */
+        cJSON* elem = value.m_node;
+        bool owned = value.m_doc && value.m_doc->owns(elem);
+        if(!owned)
+            elem = duplicate(elem);
+
+        cJSON_AddItemToObject(m_node, key.c_str(), elem);
+        if(owned)
+            value.m_doc->adopt(m_doc);
+    }
+
+    void
+    JSON::addItem(const string& key, const RawJSON& value)
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
 
-        cJSON_AddItemToObject(m_node, key.c_str(), value.m_node);
-        value.m_self->m_root = 0;
-        value.addSelf(this);
+        if((m_node->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "expected JSON object");
+
+        cJSON* elem = cJSON_CreateRaw(value.str().c_str());
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
+
+        cJSON_AddItemToObject(m_node, key.c_str(), elem);
     }
 
     void
@@ -1013,7 +1132,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON_AddNullToObject(m_node, key.c_str());
@@ -1027,7 +1149,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateBool(value);
@@ -1045,14 +1170,14 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
-        cJSON* elem = cJSON_CreateNumber(value);
-        if(0 == elem)
+        if(!cJSON_AddNumberToArray(m_node, value))
             THROW_MSG(Exception, "no memory while allocating JSON element");
-
-        cJSON_AddItemToArray(m_node, elem);
     }
 
     void
@@ -1063,14 +1188,14 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
-        cJSON* elem = cJSON_CreateNumber(value);
-        if(0 == elem)
+        if(!cJSON_AddNumberToArray(m_node, value))
             THROW_MSG(Exception, "no memory while allocating JSON element");
-
-        cJSON_AddItemToArray(m_node, elem);
     }
 
     void
@@ -1081,10 +1206,13 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
-        cJSON* elem = cJSON_CreateString(value.c_str());
+        cJSON* elem = cJSON_CreateStringWithLength(value.data(), value.size());
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON element");
 
@@ -1099,18 +1227,47 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         if(0 == value.m_node)
             THROW_MSG(Exception, "child JSON node NULL");
 
-        if(!value.m_root)
-            THROW_MSG(Exception, "child does not own JSON node");
+        /*
+         * a view into another tree goes in as a copy, an owner hands its tree over
+         */
+        cJSON* elem = value.m_node;
+        bool owned = value.m_doc && value.m_doc->owns(elem);
+        if(!owned)
+            elem = duplicate(elem);
+
+        cJSON_AddItemToArray(m_node, elem);
+        if(owned)
+            value.m_doc->adopt(m_doc);
+    }
+
+    void
+    JSON::addItem(const RawJSON& value)
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        cJSON* elem = cJSON_CreateRaw(value.str().c_str());
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON element");
 
-        cJSON_AddItemToArray(m_node, value.m_node);
-        value.m_self->m_root = 0;
-        value.addSelf(this);
+        cJSON_AddItemToArray(m_node, elem);
     }
 
     void
@@ -1121,7 +1278,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateNull();
@@ -1139,14 +1299,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON* elem = cJSON_CreateBool(value);
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        replaceElement(key, elem);
     }
 
     void
@@ -1157,14 +1320,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON* elem = cJSON_CreateNumber(value);
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        replaceElement(key, elem);
     }
 
     void
@@ -1175,14 +1341,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON* elem = cJSON_CreateNumber(value);
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        replaceElement(key, elem);
     }
 
     void
@@ -1193,14 +1362,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
-        cJSON* elem = cJSON_CreateString(value.c_str());
+        cJSON* elem = cJSON_CreateStringWithLength(value.data(), value.size());
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        replaceElement(key, elem);
     }
 
     void
@@ -1211,14 +1383,17 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         cJSON* elem = cJSON_CreateNull();
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        replaceElement(key, elem);
     }
 
     void
@@ -1229,18 +1404,50 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
         if(0 == value.m_node)
             THROW_MSG(Exception, "child JSON node NULL");
 
-        if(!value.m_root)
-            THROW_MSG(Exception, "child does not own JSON node");
+        /*
+         * a view into another tree goes in as a copy, an owner hands its tree over
+         */
+        cJSON* elem = value.m_node;
+        bool owned = value.m_doc && value.m_doc->owns(elem);
+        if(!owned)
+            elem = duplicate(elem);
+
+        if(m_caseSensitive)
+            cJSON_ReplaceItemInObjectCaseSensitive(m_node, key.c_str(), elem);
+        else
+            cJSON_ReplaceItemInObject(m_node, key.c_str(), elem);
+        if(owned)
+            value.m_doc->adopt(m_doc);
+    }
+
+    void
+    JSON::replaceItem(const string& key, const RawJSON& value)
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "expected JSON object");
+
+        cJSON* elem = cJSON_CreateRaw(value.str().c_str());
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON object element: {\"" << key << "\"}");
 
-        cJSON_ReplaceItemInObject(m_node, key.c_str(), value.m_node);
-        value.m_self->m_root = 0;
-        value.addSelf(this);
+        replaceElement(key, elem);
     }
 
     void
@@ -1251,7 +1458,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateBool(value);
@@ -1269,7 +1479,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateNumber(value);
@@ -1287,7 +1500,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateNumber(value);
@@ -1305,10 +1521,13 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
-        cJSON* elem = cJSON_CreateString(value.c_str());
+        cJSON* elem = cJSON_CreateStringWithLength(value.data(), value.size());
         if(0 == elem)
             THROW_MSG(Exception, "no memory while allocating JSON array element: [" << index << "]");
 
@@ -1323,7 +1542,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON* elem = cJSON_CreateNull();
@@ -1341,18 +1563,47 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         if(0 == value.m_node)
             THROW_MSG(Exception, "child JSON node NULL");
 
-        if(!value.m_root)
-            THROW_MSG(Exception, "child does not own JSON node");
+        /*
+         * a view into another tree goes in as a copy, an owner hands its tree over
+         */
+        cJSON* elem = value.m_node;
+        bool owned = value.m_doc && value.m_doc->owns(elem);
+        if(!owned)
+            elem = duplicate(elem);
 
-        cJSON_ReplaceItemInArray(m_node, index, value.m_node);
-        value.m_self->m_root = 0;
-        value.addSelf(this);
+        cJSON_ReplaceItemInArray(m_node, index, elem);
+        if(owned)
+            value.m_doc->adopt(m_doc);
+    }
+
+    void
+    JSON::replaceItem(int index, const RawJSON& value)
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        cJSON* elem = cJSON_CreateRaw(value.str().c_str());
+        if(0 == elem)
+            THROW_MSG(Exception, "no memory while allocating JSON array element: [" << index << "]");
+
+        cJSON_ReplaceItemInArray(m_node, index, elem);
     }
 
     void
@@ -1363,10 +1614,16 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Object)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Object)
             THROW_MSG(Exception, "expected JSON object");
 
-        cJSON_DeleteItemFromObject(m_node, key.c_str());
+        if(m_caseSensitive)
+            cJSON_DeleteItemFromObjectCaseSensitive(m_node, key.c_str());
+        else
+            cJSON_DeleteItemFromObject(m_node, key.c_str());
     }
 
     void
@@ -1377,7 +1634,10 @@ namespace JSON
         if(0 == m_node)
             THROW_MSG(Exception, "JSON node NULL");
 
-        if(m_node->type != cJSON_Array)
+        if(m_node->type & cJSON_IsFrozen)
+            THROW_MSG(Exception, "JSON is frozen");
+
+        if((m_node->type & 255) != cJSON_Array)
             THROW_MSG(Exception, "expected JSON array");
 
         cJSON_DeleteItemFromArray(m_node, index);
@@ -1389,10 +1649,24 @@ namespace JSON
         JTRACE;
         if(this != &rhs)
         {
-            if(m_root != 0)
-                removeSelf();
+            attach(rhs.m_doc, rhs.m_node);
+            m_caseSensitive = rhs.m_caseSensitive;
+        }
+        return *this;
+    }
+
+    JSON&
+    JSON::operator=(JSON&& rhs) noexcept
+    {
+        JTRACE;
+        if(this != &rhs)
+        {
+            detach();
             m_node = rhs.m_node;
-            addSelf(&rhs);
+            m_doc = rhs.m_doc;
+            m_caseSensitive = rhs.m_caseSensitive;
+            rhs.m_node = 0;
+            rhs.m_doc = 0;
         }
         return *this;
     }
@@ -1417,14 +1691,320 @@ namespace JSON
     {
         JTRACE;
 
-        return Enumeration(0 != m_node ? m_node->child : 0);
+        return Enumeration(cJSON_GetChild(m_node));
+    }
+
+    void
+    JSON::setCaseSensitive(bool caseSensitive)
+    {
+        m_caseSensitive = caseSensitive;
+    }
+
+    bool
+    JSON::isCaseSensitive() const
+    {
+        return m_caseSensitive;
+    }
+
+    Iterator
+    JSON::begin() const
+    {
+        JTRACE;
+
+        return Iterator(this, cJSON_GetChild(m_node));
+    }
+
+    Iterator
+    JSON::end() const
+    {
+        JTRACE;
+
+        return Iterator(this, 0);
     }
 
     bool
     JSON::isEmpty() const
     {
         JTRACE;
-        return 0 == m_node || ((m_node->type == cJSON_Array || m_node->type == cJSON_Object) && 0 == m_node->child);
+        return 0 == m_node || (((m_node->type & 255) == cJSON_Array || (m_node->type & 255) == cJSON_Object) && 0 == m_node->child && !(m_node->type & cJSON_IsPacked));
+    }
+
+    uint64_t
+    JSON::hash(uint64_t seed, bool ordered) const
+    {
+        JTRACE;
+        return cJSON_Hash(m_node, seed, ordered);
+    }
+
+    bool
+    JSON::equals(const JSON& other, bool ordered) const
+    {
+        JTRACE;
+        return 0 != cJSON_Compare(m_node, other.m_node, ordered);
+    }
+
+    void
+    JSON::freeze()
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if(m_node->type & cJSON_IsFrozen)
+            return;
+
+        cJSON* frozen = cJSON_Freeze(m_node);
+        if(0 == frozen)
+            THROW_MSG(Exception, "no memory while freezing JSON");
+
+        own(frozen);
+    }
+
+    size_t
+    JSON::dedupe()
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        size_t saved;
+        cJSON* frozen = cJSON_Dedupe(m_node, &saved);
+        if(0 == frozen)
+            THROW_MSG(Exception, "no memory while deduplicating JSON");
+
+        own(frozen);
+        return saved;
+    }
+
+    void
+    JSON::copyElements(size_t start, double* data, size_t n) const
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        if(n > INT_MAX || start > INT_MAX - n)
+            THROW_MSG(Exception, "JSON array index out of range: " << start + n);
+
+        size_t copied = cJSON_GetDoubleArray(m_node, start, data, n);
+        if(copied < n)
+            THROW_MSG(Exception, "JSON element is not a number: [" << start + copied << "]");
+    }
+
+    void
+    JSON::copyElements(size_t start, int64_t* data, size_t n) const
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        if(n > INT_MAX || start > INT_MAX - n)
+            THROW_MSG(Exception, "JSON array index out of range: " << start + n);
+
+        size_t copied = cJSON_GetInt64Array(m_node, start, data, n);
+        if(copied < n)
+            THROW_MSG(Exception, "JSON element is not a number: [" << start + copied << "]");
+    }
+
+    void
+    JSON::copyElements(size_t start, bool* data, size_t n) const
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        if(0 == n)
+            return;
+
+        if(start > INT_MAX)
+            THROW_MSG(Exception, "mandatory JSON array index missing: " << start);
+
+        // a packed array holds only numbers
+        if(cJSON_GetPackedItem(m_node, start, 0, 0))
+            THROW_MSG(Exception, "JSON element is not boolean: [" << start << "]");
+
+        cJSON* elem = cJSON_GetArrayItem(m_node, start);
+        for(size_t i = 0; i < n; ++i, elem = elem->next)
+        {
+            if(0 == elem)
+                THROW_MSG(Exception, "mandatory JSON array index missing: " << start + i);
+
+            switch(elem->type & 255)
+            {
+            case cJSON_False:
+                data[i] = false;
+                break;
+            case cJSON_True:
+                data[i] = true;
+                break;
+            default:
+                THROW_MSG(Exception, "JSON element is not boolean: [" << start + i << "]");
+            }
+        }
+    }
+
+    void
+    JSON::copyElements(size_t start, string* data, size_t n) const
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        if((m_node->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "expected JSON array");
+
+        if(0 == n)
+            return;
+
+        if(start > INT_MAX)
+            THROW_MSG(Exception, "mandatory JSON array index missing: " << start);
+
+        if(cJSON_GetPackedItem(m_node, start, 0, 0))
+            THROW_MSG(Exception, "JSON element is not a string: [" << start << "]");
+
+        cJSON* elem = cJSON_GetArrayItem(m_node, start);
+        for(size_t i = 0; i < n; ++i, elem = elem->next)
+        {
+            if(0 == elem)
+                THROW_MSG(Exception, "mandatory JSON array index missing: " << start + i);
+
+            if((elem->type & 255) != cJSON_String)
+                THROW_MSG(Exception, "JSON element is not a string: [" << start + i << "]");
+
+            data[i].assign(elem->valuestring, cJSON_GetStringLength(elem));
+        }
+    }
+
+    void
+    JSON::createArray(const double* data, size_t n)
+    {
+        JTRACE;
+
+        if(n > INT_MAX)
+            THROW_MSG(Exception, "too many JSON array elements: " << n);
+
+        cJSON* array = cJSON_CreatePackedDoubleArray(const_cast<double*>(data), n);
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        own(array);
+    }
+
+    void
+    JSON::createArray(const float* data, size_t n)
+    {
+        JTRACE;
+
+        if(n > INT_MAX)
+            THROW_MSG(Exception, "too many JSON array elements: " << n);
+
+        cJSON* array = cJSON_CreatePackedFloatArray(const_cast<float*>(data), n);
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        own(array);
+    }
+
+    void
+    JSON::createArray(const int* data, size_t n)
+    {
+        JTRACE;
+
+        if(n > INT_MAX)
+            THROW_MSG(Exception, "too many JSON array elements: " << n);
+
+        cJSON* array = cJSON_CreatePackedIntArray(const_cast<int*>(data), n);
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        own(array);
+    }
+
+    void
+    JSON::createArray(const int64_t* data, size_t n)
+    {
+        JTRACE;
+
+        if(n > INT_MAX)
+            THROW_MSG(Exception, "too many JSON array elements: " << n);
+
+        cJSON* array = cJSON_CreatePackedInt64Array(const_cast<int64_t*>(data), n);
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        own(array);
+    }
+
+    void
+    JSON::createArray(const bool* data, size_t n)
+    {
+        JTRACE;
+
+        cJSON* array = cJSON_CreateArray();
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        for(size_t i = 0; i < n; ++i)
+        {
+            cJSON* elem = cJSON_CreateBool(data[i]);
+            if(0 == elem)
+            {
+                cJSON_Delete(array);
+                THROW_MSG(Exception, "no memory while allocating JSON element");
+            }
+            cJSON_AddItemToArray(array, elem);
+        }
+
+        own(array);
+    }
+
+    void
+    JSON::createArray(const string* data, size_t n)
+    {
+        JTRACE;
+
+        if(n > INT_MAX)
+            THROW_MSG(Exception, "too many JSON array elements: " << n);
+
+        cJSON* array = cJSON_CreateArray();
+        for(size_t i = 0; array && i < n; ++i)
+        {
+            cJSON* elem = cJSON_CreateStringWithLength(data[i].data(), data[i].size());
+            if(0 == elem || 0 == elem->valuestring)
+            {
+                cJSON_Delete(elem);
+                cJSON_Delete(array);
+                array = 0;
+                break;
+            }
+            cJSON_AddItemToArray(array, elem);
+        }
+        if(0 == array)
+            THROW_MSG(Exception, "no memory while allocating JSON array");
+
+        own(array);
+    }
+
+    bool
+    JSON::isFrozen() const
+    {
+        JTRACE;
+        return 0 != m_node && 0 != (m_node->type & cJSON_IsFrozen);
     }
 
     bool
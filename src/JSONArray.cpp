@@ -25,6 +25,8 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <utility>
+
 #include <JSON/Exception.h>
 #include <JSON/Array.h>
 #include <JSON/Object.h>
@@ -71,6 +73,30 @@ namespace JSON
     {
     }
 
+    Array::Array(const Array& other)
+        : JSON(static_cast<const JSON&>(other))
+    {
+    }
+
+    Array::Array(Array&& other) noexcept
+        : JSON(static_cast<JSON&&>(other))
+    {
+    }
+
+    Array&
+    Array::operator=(const Array& rhs)
+    {
+        JSON::operator=(rhs);
+        return *this;
+    }
+
+    Array&
+    Array::operator=(Array&& rhs) noexcept
+    {
+        JSON::operator=(std::move(rhs));
+        return *this;
+    }
+
     JSON::Type
     Array::getType(int index) const
     {
@@ -121,6 +147,18 @@ namespace JSON
         return JSON::length();
     }
 
+    Iterator
+    Array::begin() const
+    {
+        return JSON::begin();
+    }
+
+    Iterator
+    Array::end() const
+    {
+        return JSON::end();
+    }
+
     bool
     Array::isNull(int index) const
     {
@@ -252,6 +290,18 @@ namespace JSON
         return *this;
     }
 
+    Array&
+    Array::put(int index, const RawJSON& value)
+    {
+
+        if(index < 0 || index >= (int)JSON::length())
+            THROW_MSG(Exception, "index out of bounds for JSON array: [" << index << "]");
+
+        replaceItem(index, value);
+
+        return *this;
+    }
+
     Array&
     Array::put(int index)
     {
@@ -329,6 +379,15 @@ namespace JSON
         return *this;
     }
 
+    Array&
+    Array::append(const RawJSON& value)
+    {
+
+        addItem(value);
+
+        return *this;
+    }
+
     Array&
     Array::append()
     {
@@ -347,14 +406,39 @@ namespace JSON
         return *this;
     }
 
+    Array&
+    Array::freeze()
+    {
+
+        JSON::freeze();
+
+        return *this;
+    }
+
+    size_t
+    Array::dedupe()
+    {
+
+        return JSON::dedupe();
+    }
+
+    Array
+    Array::parsePacked(const std::string& jsonstr)
+    {
+        Array array(JSON::JNONE);
+        array.JSON::parse(jsonstr.c_str(), true);
+
+        if(array.JSON::getType() != JSON::JARRAY)
+            THROW_MSG(Exception, "parse error: type mismatch");
+
+        return array;
+    }
+
     bool
     Array::operator==(const Array& other) const
     {
 
-        /*
-         * compare compressed JSON
-         */
-        return toString() == other.toString();
+        return equals(other);
     }
 
     bool
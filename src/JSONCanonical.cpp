@@ -0,0 +1,369 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <JSON/JSON.h>
+#include <JSON/Writer.h>
+
+namespace JSON
+{
+
+    using namespace std;
+
+    namespace
+    {
+
+        /**
+         * Decode the UTF-8 sequence at @a ptr as UTF-16 code units
+         *
+         * @param ptr start of sequence, advanced past it
+         * @param units receives one or two code units
+         * @return number of code units
+         */
+        int
+        utf16(const unsigned char*& ptr, unsigned units[2])
+        {
+            unsigned c = *ptr++;
+            int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+            if(extra)
+                c &= 0x3F >> extra;
+            for(; extra > 0 && (*ptr & 0xC0) == 0x80; --extra)
+                c = (c << 6) | (*ptr++ & 0x3F);
+
+            if(c < 0x10000)
+            {
+                units[0] = c;
+                return 1;
+            }
+            c -= 0x10000;
+            units[0] = 0xD800 | (c >> 10);
+            units[1] = 0xDC00 | (c & 0x3FF);
+            return 2;
+        }
+
+        /**
+         * Order keys by UTF-16 code units as RFC 8785 requires. UTF-8 byte order
+         * is code point order, which only differs from UTF-16 order when one side
+         * is outside the basic multilingual plane, so bytes are compared until
+         * they differ and only then decoded.
+         */
+        bool
+        keyLess(const cJSON* a, const cJSON* b)
+        {
+            const unsigned char* pa = reinterpret_cast<const unsigned char*>(a->string ? a->string : "");
+            const unsigned char* pb = reinterpret_cast<const unsigned char*>(b->string ? b->string : "");
+
+            while(*pa && *pa == *pb)
+                ++pa, ++pb;
+
+            if(*pa < 0x80 || *pb < 0x80)
+                return *pa < *pb;
+
+            /*
+             * back up to the start of the differing character
+             */
+            while((*pa & 0xC0) == 0x80)
+                --pa, --pb;
+
+            unsigned ua[2], ub[2];
+            utf16(pa, ua);
+            utf16(pb, ub);
+            if(ua[0] != ub[0])
+                return ua[0] < ub[0];
+
+            /*
+             * same high surrogate
+             */
+            return ua[1] < ub[1];
+        }
+
+        /**
+         * Writes canonical JSON, optionally hashing the text block by block
+         */
+        class Canonical
+        {
+            string& m_out;
+            Writer m_writer;
+            bool m_hashing;
+            bool m_keep;
+            size_t m_hashed;
+            uint64_t m_hash;
+            vector< vector<const cJSON*> > m_members;
+
+            void flush()
+            {
+                if(m_hashing)
+                {
+                    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(m_out.data()) + m_hashed;
+                    const unsigned char* end = reinterpret_cast<const unsigned char*>(m_out.data()) + m_out.size();
+                    for(; ptr < end; ++ptr)
+                        m_hash = (m_hash ^ *ptr) * 1099511628211ULL;
+                    m_hashed = m_out.size();
+                }
+                if(!m_keep)
+                {
+                    m_out.clear();
+                    m_hashed = 0;
+                }
+            }
+
+            void number(double d)
+            {
+                if(std::isnan(d) || std::isinf(d))
+                    THROW_MSG(Exception, "canonical JSON cannot represent number: " << d);
+
+                if(d == 0)
+                {
+                    m_out += '0';
+                    return;
+                }
+
+                /*
+                 * find the shortest decimal that reads back as the same double
+                 */
+                char buf[32];
+                for(int precision = 1; precision <= 17; ++precision)
+                {
+                    snprintf(buf, sizeof(buf), "%.*e", precision - 1, d);
+                    if(strtod(buf, 0) == d)
+                        break;
+                }
+
+                /*
+                 * split "-d.ddde+xx" into digits and decimal exponent
+                 */
+                const char* ptr = buf;
+                if(*ptr == '-')
+                {
+                    m_out += '-';
+                    ++ptr;
+                }
+                char digits[20];
+                int k = 0;
+                for(; *ptr != 'e'; ++ptr)
+                    if(*ptr != '.')
+                        digits[k++] = *ptr;
+                int n = atoi(ptr + 1) + 1;
+
+                /*
+                 * ECMAScript Number::toString
+                 */
+                if(k <= n && n <= 21)
+                {
+                    m_out.append(digits, k);
+                    m_out.append(n - k, '0');
+                }
+                else if(0 < n && n <= 21)
+                {
+                    m_out.append(digits, n);
+                    m_out += '.';
+                    m_out.append(digits + n, k - n);
+                }
+                else if(-6 < n && n <= 0)
+                {
+                    m_out.append("0.", 2);
+                    m_out.append(-n, '0');
+                    m_out.append(digits, k);
+                }
+                else
+                {
+                    m_out += digits[0];
+                    if(k > 1)
+                    {
+                        m_out += '.';
+                        m_out.append(digits + 1, k - 1);
+                    }
+                    snprintf(buf, sizeof(buf), "e%c%d", n - 1 < 0 ? '-' : '+', abs(n - 1));
+                    m_out += buf;
+                }
+            }
+
+        public:
+            Canonical(string& out, bool hashing, bool keep)
+                : m_out(out)
+                , m_writer(out)
+                , m_hashing(hashing)
+                , m_keep(keep)
+                , m_hashed(out.size())
+                , m_hash(14695981039346656037ULL)
+            {
+            }
+
+            uint64_t finish()
+            {
+                flush();
+                return m_hash;
+            }
+
+            void value(const cJSON* item, size_t depth)
+            {
+                switch(item->type & 255)
+                {
+                case cJSON_NULL:
+                    m_writer.null();
+                    break;
+                case cJSON_False:
+                    m_writer.boolean(false);
+                    break;
+                case cJSON_True:
+                    m_writer.boolean(true);
+                    break;
+                case cJSON_Number:
+                    number(item->valuedouble);
+                    break;
+                case cJSON_String:
+                    m_writer.string(item->valuestring, cJSON_GetStringLength(item));
+                    break;
+                case cJSON_Raw:
+                    {
+                        cJSON* raw = cJSON_Parse(item->valuestring);
+                        if(0 == raw)
+                            THROW_MSG(Exception, "parse error: " << item->valuestring);
+                        try
+                        {
+                            value(raw, depth);
+                        }
+                        catch(...)
+                        {
+                            cJSON_Delete(raw);
+                            throw;
+                        }
+                        cJSON_Delete(raw);
+                    }
+                    break;
+                case cJSON_Array:
+                    m_out += '[';
+                    if(cJSON_GetPackedItem(const_cast<cJSON*>(item), 0, 0, 0))
+                    {
+                        /*
+                         * the numbers of a packed array are written without making nodes,
+                         * from the nodes if another reader makes them meanwhile
+                         */
+                        cJSON* array = const_cast<cJSON*>(item);
+                        int count = cJSON_GetArraySize(array);
+                        for(int i = 0; i < count; ++i)
+                        {
+                            double d;
+                            if(!cJSON_GetPackedItem(array, i, &d, 0))
+                                d = cJSON_GetArrayItem(array, i)->valuedouble;
+                            if(i)
+                                m_out += ',';
+                            number(d);
+                        }
+                    }
+                    else
+                    {
+                        for(const cJSON* child = cJSON_GetChild(const_cast<cJSON*>(item)); child; child = child->next)
+                        {
+                            if(child->prev)
+                                m_out += ',';
+                            value(child, depth + 1);
+                        }
+                    }
+                    m_out += ']';
+                    break;
+                case cJSON_Object:
+                    {
+                        /*
+                         * one member list per depth, reused between objects
+                         */
+                        if(m_members.size() <= depth)
+                            m_members.resize(depth + 1);
+
+                        m_members[depth].clear();
+                        for(const cJSON* child = item->child; child; child = child->next)
+                            m_members[depth].push_back(child);
+                        stable_sort(m_members[depth].begin(), m_members[depth].end(), keyLess);
+
+                        m_out += '{';
+                        for(size_t i = 0; i < m_members[depth].size(); ++i)
+                        {
+                            const cJSON* child = m_members[depth][i];
+                            if(i)
+                                m_out += ',';
+                            m_writer.string(child->string, cJSON_GetKeyLength(child));
+                            m_out += ':';
+                            value(child, depth + 1);
+                        }
+                        m_out += '}';
+                    }
+                    break;
+                }
+
+                if(m_out.size() - m_hashed >= 4096)
+                    flush();
+            }
+        };
+
+    } /* namespace */
+
+    string
+    JSON::toCanonicalString() const
+    {
+        JTRACE;
+
+        string jsonstring;
+        if(0 != m_node)
+        {
+            Canonical canonical(jsonstring, false, true);
+            canonical.value(m_node, 0);
+        }
+        return jsonstring;
+    }
+
+    string
+    JSON::toCanonicalString(uint64_t& hash) const
+    {
+        JTRACE;
+
+        string jsonstring;
+        Canonical canonical(jsonstring, true, true);
+        if(0 != m_node)
+            canonical.value(m_node, 0);
+        hash = canonical.finish();
+        return jsonstring;
+    }
+
+    uint64_t
+    JSON::canonicalHash() const
+    {
+        JTRACE;
+
+        string block;
+        Canonical canonical(block, true, false);
+        if(0 != m_node)
+            canonical.value(m_node, 0);
+        return canonical.finish();
+    }
+
+} /* namespace JSON */
@@ -0,0 +1,253 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <JSON/Compact.h>
+#include <JSON/cJSON/cJSON.h>
+
+using namespace std;
+
+namespace JSON
+{
+
+    Compact::Compact(const string& json)
+        : m_doc(cJSON_ParseCompact(json.c_str()))
+    {
+        if(0 == m_doc)
+            THROW_MSG(Exception, "parse error: " << json);
+    }
+
+    Compact::Compact(const char* json)
+        : m_doc(json ? cJSON_ParseCompact(json) : 0)
+    {
+        if(0 == m_doc)
+            THROW_MSG(Exception, "parse error: " << (json ? json : "NULL"));
+    }
+
+    Compact::Compact(const JSON& json)
+        : m_doc(0)
+    {
+        if(0 == json.m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+        m_doc = cJSON_CompactTree(json.m_node);
+        if(0 == m_doc)
+            THROW_MSG(Exception, "out of memory compacting JSON");
+    }
+
+    Compact::~Compact()
+    {
+        cJSON_DeleteCompact(m_doc);
+    }
+
+    Compact::Node
+    Compact::root() const
+    {
+        return Node(m_doc, cJSON_CompactRoot(m_doc));
+    }
+
+    size_t
+    Compact::bytes() const
+    {
+        return cJSON_CompactSize(m_doc);
+    }
+
+    size_t
+    Compact::shapes() const
+    {
+        return cJSON_CompactShapes(m_doc);
+    }
+
+    void
+    Compact::own(JSON& value, cJSON* tree)
+    {
+        value.own(tree);
+    }
+
+    JSON::Type
+    Compact::Node::getType() const
+    {
+        switch(m_node->type & 255)
+        {
+        case cJSON_False:
+        case cJSON_True:
+            return JSON::JBOOLEAN;
+        case cJSON_NULL:
+            return JSON::JNULL;
+        case cJSON_Number:
+            return JSON::JNUMBER;
+        case cJSON_String:
+            return JSON::JSTRING;
+        case cJSON_Array:
+            return JSON::JARRAY;
+        case cJSON_Object:
+            return JSON::JOBJECT;
+        case cJSON_Raw:
+            return JSON::JRAW;
+        }
+        /*
+         * shouldn't get here, but all JSON data types are UTF-8 strings
+         */
+        return JSON::JSTRING;
+    }
+
+    string
+    Compact::Node::key() const
+    {
+        const char* key = cJSON_CompactKey(m_doc, m_node);
+        return key ? string(key) : string();
+    }
+
+    size_t
+    Compact::Node::size() const
+    {
+        switch(m_node->type & 255)
+        {
+        case cJSON_Array:
+        case cJSON_Object:
+            return m_node->count;
+        }
+        return 0;
+    }
+
+    Compact::Node
+    Compact::Node::operator[](int index) const
+    {
+        const cJSON_CompactNode* item = cJSON_CompactItem(m_doc, m_node, index);
+        if(0 == item)
+            THROW_MSG(Exception, "JSON index out of range: " << describe() << "[" << index << "]");
+        return Node(m_doc, item);
+    }
+
+    Compact::Node
+    Compact::Node::operator[](const string& key) const
+    {
+        if((m_node->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "JSON element is not an object: " << describe());
+        const cJSON_CompactNode* item = cJSON_CompactObjectItem(m_doc, m_node, key.c_str());
+        if(0 == item)
+            THROW_MSG(Exception, "JSON object has no member: {\"" << key << "\"}");
+        return Node(m_doc, item);
+    }
+
+    Compact::Node
+    Compact::Node::operator[](const Field& field) const
+    {
+        if((m_node->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "JSON element is not an object: " << describe());
+        cJSON_CompactSlot slot = { field.m_shape, field.m_position };
+        const cJSON_CompactNode* item = cJSON_CompactObjectItemSlot(m_doc, m_node, field.m_key.c_str(), &slot);
+        field.m_shape = slot.shape;
+        field.m_position = slot.position;
+        if(0 == item)
+            THROW_MSG(Exception, "JSON object has no member: {\"" << field.m_key << "\"}");
+        return Node(m_doc, item);
+    }
+
+    bool
+    Compact::Node::has(const string& key) const
+    {
+        return 0 != cJSON_CompactObjectItem(m_doc, m_node, key.c_str());
+    }
+
+    bool
+    Compact::Node::isNull() const
+    {
+        return cJSON_NULL == (m_node->type & 255);
+    }
+
+    bool
+    Compact::Node::getBoolean() const
+    {
+        switch(m_node->type & 255)
+        {
+        case cJSON_False:
+            return false;
+        case cJSON_True:
+            return true;
+        }
+        THROW_MSG(Exception, "JSON element is not boolean: " << describe());
+        /* notreached */
+        return false;
+    }
+
+    double
+    Compact::Node::getDouble() const
+    {
+        if((m_node->type & 255) != cJSON_Number)
+            THROW_MSG(Exception, "JSON element is not a number: " << describe());
+        return cJSON_CompactDouble(m_node);
+    }
+
+    long
+    Compact::Node::getLong() const
+    {
+        if((m_node->type & 255) != cJSON_Number)
+            THROW_MSG(Exception, "JSON element is not a number: " << describe());
+        return (long)cJSON_CompactInt64(m_node);
+    }
+
+    string
+    Compact::Node::getString() const
+    {
+        if((m_node->type & 255) == cJSON_String)
+            return string(cJSON_CompactString(m_doc, m_node), m_node->count);
+        return toString();
+    }
+
+    string
+    Compact::Node::toString() const
+    {
+        cJSON* tree = cJSON_CompactExpand(m_doc, m_node);
+        if(0 == tree)
+            THROW_MSG(Exception, "out of memory expanding JSON element: " << describe());
+        char* json = cJSON_PrintUnformatted(tree);
+        cJSON_Delete(tree);
+        if(0 == json)
+            THROW_MSG(Exception, "out of memory printing JSON element: " << describe());
+        string jsonstring = json;
+        cJSON_free(json);
+        return jsonstring;
+    }
+
+    void
+    Compact::Node::expand(JSON& value) const
+    {
+        cJSON* tree = cJSON_CompactExpand(m_doc, m_node);
+        if(0 == tree)
+            THROW_MSG(Exception, "out of memory expanding JSON element: " << describe());
+        Compact::own(value, tree);
+    }
+
+    string
+    Compact::Node::describe() const
+    {
+        const char* key = cJSON_CompactKey(m_doc, m_node);
+        if(0 == key)
+            return "[]";
+        return string("{\"") + key + "\"}";
+    }
+
+} /* namespace JSON */
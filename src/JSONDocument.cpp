@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <JSON/cJSON/cJSON.h>
+#include <JSON/Document.h>
+
+namespace JSON
+{
+
+    Document::Document(cJSON* root)
+        : m_refs(1)
+        , m_root(root)
+        , m_owner(0)
+    {
+    }
+
+    Document::~Document()
+    {
+        if(m_root)
+            cJSON_Delete(m_root);
+        if(m_owner)
+            m_owner->release();
+    }
+
+    Document*
+    Document::create(cJSON* root)
+    {
+        if(0 == root)
+            return 0;
+
+        try
+        {
+            return new Document(root);
+        }
+        catch(...)
+        {
+            cJSON_Delete(root);
+            throw;
+        }
+    }
+
+    void
+    Document::adopt(Document* owner) noexcept
+    {
+        if(owner)
+            owner->retain();
+        if(m_owner)
+            m_owner->release();
+        m_owner = owner;
+        m_root = 0;
+    }
+
+} /* namespace JSON */
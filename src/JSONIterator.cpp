@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <JSON/cJSON/cJSON.h>
+#include <JSON/Iterator.h>
+
+using namespace std;
+
+namespace JSON
+{
+
+    JSON::Type
+    Value::getType() const
+    {
+        switch(m_item->type & 255)
+        {
+        case cJSON_False:
+        case cJSON_True:
+            return JSON::JBOOLEAN;
+        case cJSON_NULL:
+            return JSON::JNULL;
+        case cJSON_Number:
+            return JSON::JNUMBER;
+        case cJSON_String:
+            return JSON::JSTRING;
+        case cJSON_Array:
+            return JSON::JARRAY;
+        case cJSON_Object:
+            return JSON::JOBJECT;
+        case cJSON_Raw:
+            return JSON::JRAW;
+        }
+        /*
+         * shouldn't get here, but all JSON data types are UTF-8 strings
+         */
+        return JSON::JSTRING;
+    }
+
+    bool
+    Value::isNull() const
+    {
+        return cJSON_NULL == (m_item->type & 255);
+    }
+
+    bool
+    Value::getBoolean() const
+    {
+        switch(m_item->type & 255)
+        {
+        case cJSON_False:
+            return false;
+        case cJSON_True:
+            return true;
+        }
+        THROW_MSG(Exception, "JSON element is not boolean: " << describe());
+        /* notreached */
+        return false;
+    }
+
+    double
+    Value::getDouble() const
+    {
+        if((m_item->type & 255) != cJSON_Number)
+            THROW_MSG(Exception, "JSON element is not a number: " << describe());
+        return m_item->valuedouble;
+    }
+
+    long
+    Value::getLong() const
+    {
+        if((m_item->type & 255) != cJSON_Number)
+            THROW_MSG(Exception, "JSON element is not a number: " << describe());
+        return (long)m_item->valueint;
+    }
+
+    string
+    Value::getString() const
+    {
+        if((m_item->type & 255) == cJSON_String)
+            return string(m_item->valuestring, cJSON_GetStringLength(m_item));
+        return toString();
+    }
+
+    void
+    Value::getJSONArray(JSON& value) const
+    {
+        if((m_item->type & 255) != cJSON_Array)
+            THROW_MSG(Exception, "JSON element is not an array: " << describe());
+
+        value.attach(m_parent->m_doc, m_item);
+    }
+
+    void
+    Value::getJSONObject(JSON& value) const
+    {
+        if((m_item->type & 255) != cJSON_Object)
+            THROW_MSG(Exception, "JSON element is not an object: " << describe());
+
+        value.attach(m_parent->m_doc, m_item);
+    }
+
+    string
+    Value::toString() const
+    {
+        char* json = cJSON_PrintUnformatted(m_item);
+        string jsonstring = json;
+        cJSON_free(json);
+        return jsonstring;
+    }
+
+    string
+    Value::describe() const
+    {
+        if(0 == m_item->string)
+            return "[]";
+        return string("{\"") + m_item->string + "\"}";
+    }
+
+} /* namespace JSON */
@@ -0,0 +1,370 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+
+#include <JSON/cJSON/cJSON.h>
+#include <JSON/Object.h>
+#include <JSON/Writer.h>
+#include <JSON/LogSink.h>
+
+using namespace std;
+
+namespace JSON
+{
+
+    /**
+     * Valid JSON holds newlines only as white space, raw text has them written
+     * as spaces from @a from on so that every entry stays on one line.
+     */
+    static void
+    flatten(string& text, size_t from = 0)
+    {
+        for(size_t i = text.find_first_of("\r\n", from); i != string::npos; i = text.find_first_of("\r\n", i + 1))
+            text[i] = ' ';
+    }
+
+    LogSink::Record::Field&
+    LogSink::Record::add(const string& key, Kind kind)
+    {
+        m_fields.push_back(Field());
+        Field& field = m_fields.back();
+        field.key = key;
+        field.kind = kind;
+        return field;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key, bool value)
+    {
+        add(key, KBOOLEAN).boolean = value;
+        return *this;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key, double value)
+    {
+        add(key, KDOUBLE).number = value;
+        return *this;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key, const string& value)
+    {
+        add(key, KSTRING).text = value;
+        return *this;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key, const char* value)
+    {
+        if(value == NULL)
+            return put(key);
+        add(key, KSTRING).text = value;
+        return *this;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key, const RawJSON& value)
+    {
+        string& text = add(key, KRAW).text;
+        text = value.str();
+        flatten(text);
+        return *this;
+    }
+
+    LogSink::Record&
+    LogSink::Record::put(const string& key)
+    {
+        add(key, KNULL);
+        return *this;
+    }
+
+    LogSink::LogSink(int fd, size_t capacity, Policy policy, size_t batchBytes)
+        : m_fd(fd)
+        , m_policy(policy)
+        , m_batchBytes(batchBytes)
+        , m_mask(0)
+        , m_slots(0)
+        , m_tail(0)
+        , m_head(0)
+        , m_written(0)
+        , m_dropped(0)
+        , m_stop(false)
+        , m_sleeping(false)
+    {
+        if(fd < 0)
+            THROW_MSG(Exception, "invalid file descriptor " << fd);
+        if(capacity == 0)
+            THROW_MSG(Exception, "log sink capacity must not be zero");
+
+        size_t size = 1;
+        while(size < capacity)
+            size <<= 1;
+        const_cast<size_t&>(m_mask) = size - 1;
+
+        m_slots = new Slot[size];
+        for(size_t i = 0; i < size; ++i)
+        {
+            m_slots[i].sequence.store(i, memory_order_relaxed);
+            m_slots[i].tree = 0;
+        }
+
+        m_thread = thread(&LogSink::run, this);
+    }
+
+    LogSink::~LogSink()
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop.store(true);
+            m_wakeup.notify_one();
+        }
+        m_thread.join();
+        delete[] m_slots;
+    }
+
+    /**
+     * Claim the next slot for writing, a bounded multi producer queue after Dmitry Vyukov.
+     * The slot's sequence equals the position when it is free for that position.
+     */
+    LogSink::Slot*
+    LogSink::claim()
+    {
+        size_t pos = m_tail.load(memory_order_relaxed);
+        for(;;)
+        {
+            Slot* slot = &m_slots[pos & m_mask];
+            size_t seq = slot->sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if(diff == 0)
+            {
+                if(m_tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    return slot;
+            }
+            else if(diff < 0)
+            {
+                if(m_policy == DROP)
+                {
+                    m_dropped.fetch_add(1, memory_order_relaxed);
+                    return 0;
+                }
+                this_thread::yield();
+                pos = m_tail.load(memory_order_relaxed);
+            }
+            else
+                pos = m_tail.load(memory_order_relaxed);
+        }
+    }
+
+    void
+    LogSink::publish(Slot* slot)
+    {
+        size_t pos = slot->sequence.load(memory_order_relaxed);
+        slot->sequence.store(pos + 1, memory_order_release);
+
+        // pairs with the fence in run() so either we see the consumer
+        // asleep or it sees this slot before it sleeps
+        atomic_thread_fence(memory_order_seq_cst);
+        if(m_sleeping.load(memory_order_relaxed))
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_wakeup.notify_one();
+        }
+    }
+
+    bool
+    LogSink::log(const Object& obj)
+    {
+        if(0 == obj.m_node)
+            THROW_MSG(Exception, "Not initialized");
+
+        cJSON* tree = cJSON_Duplicate(obj.m_node, 1);
+        if(0 == tree)
+            THROW_MSG(Exception, "out of memory");
+
+        Slot* slot = claim();
+        if(0 == slot)
+        {
+            cJSON_Delete(tree);
+            return false;
+        }
+        slot->tree = tree;
+        publish(slot);
+        return true;
+    }
+
+    bool
+    LogSink::log(const Record& record)
+    {
+        Slot* slot = claim();
+        if(0 == slot)
+            return false;
+        slot->fields = record.m_fields;
+        publish(slot);
+        return true;
+    }
+
+    bool
+    LogSink::log(const RawJSON& json)
+    {
+        Slot* slot = claim();
+        if(0 == slot)
+            return false;
+        slot->text = json.str();
+        flatten(slot->text);
+        publish(slot);
+        return true;
+    }
+
+    void
+    LogSink::flush()
+    {
+        size_t target = m_tail.load(memory_order_acquire);
+        unique_lock<mutex> lock(m_mutex);
+        while(m_written.load(memory_order_acquire) < target)
+            m_drained.wait(lock);
+    }
+
+    size_t
+    LogSink::dropped() const
+    {
+        return m_dropped.load(memory_order_relaxed);
+    }
+
+    void
+    LogSink::write(string& batch, size_t entries)
+    {
+        const char* data = batch.data();
+        size_t remaining = batch.size();
+        while(remaining > 0)
+        {
+            ssize_t n = ::write(m_fd, data, remaining);
+            if(n < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                m_dropped.fetch_add(entries, memory_order_relaxed);
+                break;
+            }
+            data += n;
+            remaining -= static_cast<size_t>(n);
+        }
+        batch.clear();
+    }
+
+    void
+    LogSink::run()
+    {
+        string batch;
+        batch.reserve(m_batchBytes + 4096);
+        size_t entries = 0;
+
+        for(;;)
+        {
+            Slot* slot = &m_slots[m_head & m_mask];
+            if(slot->sequence.load(memory_order_acquire) == m_head + 1)
+            {
+                if(0 != slot->tree)
+                {
+                    char* json = cJSON_PrintUnformatted(slot->tree);
+                    if(json != NULL)
+                    {
+                        // strings are escaped, only raw values can hold a newline
+                        size_t start = batch.size();
+                        batch.append(json);
+                        cJSON_free(json);
+                        flatten(batch, start);
+                    }
+                    cJSON_Delete(slot->tree);
+                    slot->tree = 0;
+                }
+                else if(!slot->text.empty())
+                {
+                    batch.append(slot->text);
+                    slot->text.clear();
+                }
+                else
+                {
+                    Writer writer(batch);
+                    writer.raw("{", 1);
+                    for(size_t i = 0; i < slot->fields.size(); ++i)
+                    {
+                        const Record::Field& field = slot->fields[i];
+                        if(i > 0)
+                            writer.raw(",", 1);
+                        writer.string(field.key).raw(":", 1);
+                        switch(field.kind)
+                        {
+                        case Record::KNULL: writer.null(); break;
+                        case Record::KBOOLEAN: writer.boolean(field.boolean); break;
+                        case Record::KINTEGER: writer.number(field.integer); break;
+                        case Record::KDOUBLE: writer.number(field.number); break;
+                        case Record::KSTRING: writer.string(field.text); break;
+                        case Record::KRAW: writer.raw(field.text.data(), field.text.size()); break;
+                        }
+                    }
+                    writer.raw("}", 1);
+                    slot->fields.clear();
+                }
+                batch.push_back('\n');
+                ++entries;
+
+                slot->sequence.store(m_head + m_mask + 1, memory_order_release);
+                ++m_head;
+
+                if(batch.size() < m_batchBytes)
+                    continue;
+            }
+
+            if(entries > 0)
+            {
+                write(batch, entries);
+                entries = 0;
+                lock_guard<mutex> lock(m_mutex);
+                m_written.store(m_head, memory_order_release);
+                m_drained.notify_all();
+                continue;
+            }
+
+            unique_lock<mutex> lock(m_mutex);
+            m_sleeping.store(true, memory_order_relaxed);
+            atomic_thread_fence(memory_order_seq_cst);
+            slot = &m_slots[m_head & m_mask];
+            if(slot->sequence.load(memory_order_relaxed) != m_head + 1)
+            {
+                if(m_stop.load())
+                    break;
+                m_wakeup.wait(lock);
+            }
+            m_sleeping.store(false, memory_order_relaxed);
+        }
+    }
+
+} /* namespace JSON */
@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <JSON/Exception.h>
+#include <JSON/NumberReader.h>
+#include <JSON/cJSON/cJSON.h>
+
+namespace JSON
+{
+
+    using namespace std;
+
+    namespace
+    {
+
+        const char*
+        skip(const char* ptr)
+        {
+            while(*ptr && (unsigned char)*ptr <= 32)
+                ++ptr;
+            return ptr;
+        }
+
+        const char*
+        scan(const char* ptr, double& value)
+        {
+            return cJSON_ScanNumber(ptr, &value, 0);
+        }
+
+        const char*
+        scan(const char* ptr, int64_t& value)
+        {
+            double number;
+            const char* end = cJSON_ScanNumber(ptr, &number, &value);
+            // the kernel yields 0 for anything outside the int64_t range
+            if(end && 0 == value && !(number > -1.0 && number < 1.0))
+                THROW_MSG(Exception, "Number out of int64_t range: " << number);
+            return end;
+        }
+
+        template<typename T>
+        struct Append
+        {
+            vector<T>& values;
+
+            void
+            operator()(size_t, size_t, T value)
+            {
+                values.push_back(value);
+            }
+        };
+
+        template<typename T>
+        struct Strided
+        {
+            T* data;
+            size_t stride;
+            size_t rows;
+
+            void
+            operator()(size_t row, size_t column, T value)
+            {
+                if(row >= rows)
+                    THROW_MSG(Exception, "Array has more than " << rows << " rows");
+                data[row * stride + column] = value;
+            }
+        };
+
+        /**
+         * Walk an array of numbers, or of @a width-tuples of numbers, handing
+         * every value to @a store. Returns the number of rows.
+         */
+        template<typename T, typename Store>
+        size_t
+        decode(const string& json, size_t width, Store store)
+        {
+            const char* begin = json.c_str();
+            const char* end = begin + json.size();
+            const char* ptr = skip(begin);
+            size_t rows = 0;
+            T value;
+
+            if(*ptr != '[')
+                THROW_MSG(Exception, "Expected '[' at offset " << (ptr - begin));
+            ptr = skip(ptr + 1);
+            if(*ptr != ']')
+            {
+                for(;;)
+                {
+                    if(0 == width)
+                    {
+                        const char* next = scan(ptr, value);
+                        if(0 == next)
+                            THROW_MSG(Exception, "Expected number at offset " << (ptr - begin));
+                        store(rows, 0, value);
+                        ptr = next;
+                    }
+                    else
+                    {
+                        if(*ptr != '[')
+                            THROW_MSG(Exception, "Expected '[' at offset " << (ptr - begin));
+                        for(size_t column = 0; column < width; ++column)
+                        {
+                            ptr = skip(ptr + 1);
+                            const char* next = scan(ptr, value);
+                            if(0 == next)
+                                THROW_MSG(Exception, "Expected number at offset " << (ptr - begin));
+                            store(rows, column, value);
+                            ptr = skip(next);
+                            if(*ptr != (column + 1 < width ? ',' : ']'))
+                                THROW_MSG(Exception, "Tuple of width " << width << " malformed at offset " << (ptr - begin));
+                        }
+                        ++ptr;
+                    }
+                    ++rows;
+                    ptr = skip(ptr);
+                    if(*ptr == ']')
+                        break;
+                    if(*ptr != ',')
+                        THROW_MSG(Exception, "Expected ',' or ']' at offset " << (ptr - begin));
+                    ptr = skip(ptr + 1);
+                }
+            }
+            ptr = skip(ptr + 1);
+            if(ptr != end)
+                THROW_MSG(Exception, "Unexpected text at offset " << (ptr - begin));
+            return rows;
+        }
+
+        template<typename T>
+        size_t
+        decodeStrided(const string& json, size_t width, T* data, size_t stride, size_t rows)
+        {
+            if(stride < (width ? width : 1))
+                THROW_MSG(Exception, "Stride " << stride << " smaller than width " << width);
+            if(0 == data && rows)
+                THROW_MSG(Exception, "Buffer NULL");
+            Strided<T> store = { data, stride, rows };
+            return decode<T>(json, width, store);
+        }
+
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, std::vector<double>& values)
+    {
+        Append<double> store = { values };
+        return decode<double>(json, 0, store);
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, std::vector<int64_t>& values)
+    {
+        Append<int64_t> store = { values };
+        return decode<int64_t>(json, 0, store);
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, size_t width, std::vector<double>& values)
+    {
+        Append<double> store = { values };
+        return decode<double>(json, width, store);
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, size_t width, std::vector<int64_t>& values)
+    {
+        Append<int64_t> store = { values };
+        return decode<int64_t>(json, width, store);
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, size_t width, double* data, size_t stride, size_t rows)
+    {
+        return decodeStrided(json, width, data, stride, rows);
+    }
+
+    size_t
+    NumberReader::read(const std::string& json, size_t width, int64_t* data, size_t stride, size_t rows)
+    {
+        return decodeStrided(json, width, data, stride, rows);
+    }
+
+}
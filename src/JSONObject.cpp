@@ -25,6 +25,9 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <utility>
+
+#include <JSON/cJSON/cJSON.h>
 #include <JSON/Exception.h>
 #include <JSON/Array.h>
 #include <JSON/Object.h>
@@ -80,6 +83,30 @@ namespace JSON
     {
     }
 
+    Object::Object(const Object& other)
+        : JSON(static_cast<const JSON&>(other))
+    {
+    }
+
+    Object::Object(Object&& other) noexcept
+        : JSON(static_cast<JSON&&>(other))
+    {
+    }
+
+    Object&
+    Object::operator=(const Object& rhs)
+    {
+        JSON::operator=(rhs);
+        return *this;
+    }
+
+    Object&
+    Object::operator=(Object&& rhs) noexcept
+    {
+        JSON::operator=(std::move(rhs));
+        return *this;
+    }
+
     JSON::Type
     Object::getType(const std::string& key) const
     {
@@ -137,6 +164,18 @@ namespace JSON
         return JSON::length();
     }
 
+    Iterator
+    Object::begin() const
+    {
+        return JSON::begin();
+    }
+
+    Iterator
+    Object::end() const
+    {
+        return JSON::end();
+    }
+
     bool
     Object::isNull(const std::string& key) const
     {
@@ -197,10 +236,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for boolean value");
 
-        if(JSON::has(key))
-            replaceItem(key, value);
-        else
-            addItem(key, value);
+        setItem(key, cJSON_CreateBool(value));
 
         return *this;
     }
@@ -212,10 +248,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for double number value");
 
-        if(JSON::has(key))
-            replaceItem(key, value);
-        else
-            addItem(key, value);
+        setItem(key, cJSON_CreateNumber(value));
 
         return *this;
     }
@@ -227,10 +260,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for long number value");
 
-        if(JSON::has(key))
-            replaceItem(key, value);
-        else
-            addItem(key, value);
+        setItem(key, cJSON_CreateNumber(value));
 
         return *this;
     }
@@ -242,10 +272,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for string value");
 
-        if(JSON::has(key))
-            replaceItem(key, value);
-        else
-            addItem(key, value);
+        setItem(key, cJSON_CreateStringWithLength(value.data(), value.size()));
 
         return *this;
     }
@@ -267,10 +294,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for JSON array");
 
-        if(JSON::has(key))
-            replaceItem(key, dynamic_cast<const JSON&>(value));
-        else
-            addItem(key, dynamic_cast<const JSON&>(value));
+        setItem(key, dynamic_cast<const JSON&>(value));
 
         return *this;
     }
@@ -282,10 +306,19 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for JSON object");
 
-        if(JSON::has(key))
-            replaceItem(key, dynamic_cast<const JSON&>(value));
-        else
-            addItem(key, dynamic_cast<const JSON&>(value));
+        setItem(key, dynamic_cast<const JSON&>(value));
+
+        return *this;
+    }
+
+    Object&
+    Object::put(const std::string& key, const RawJSON& value)
+    {
+
+        if(key.empty())
+            THROW_MSG(Exception, "no key provided for raw JSON value");
+
+        setItem(key, cJSON_CreateRaw(value.str().c_str()));
 
         return *this;
     }
@@ -297,10 +330,7 @@ namespace JSON
         if(key.empty())
             THROW_MSG(Exception, "no key provided for null value");
 
-        if(JSON::has(key))
-            replaceNullItem(key);
-        else
-            addNullItem(key);
+        setItem(key, cJSON_CreateNull());
 
         return *this;
     }
@@ -433,14 +463,39 @@ namespace JSON
         return *this;
     }
 
+    Object&
+    Object::freeze()
+    {
+
+        JSON::freeze();
+
+        return *this;
+    }
+
+    size_t
+    Object::dedupe()
+    {
+
+        return JSON::dedupe();
+    }
+
+    Object
+    Object::parsePacked(const std::string& jsonstr)
+    {
+        Object obj(JSON::JNONE);
+        obj.JSON::parse(jsonstr.c_str(), true);
+
+        if(obj.JSON::getType() != JSON::JOBJECT)
+            THROW_MSG(Exception, "parse error: type mismatch");
+
+        return obj;
+    }
+
     bool
     Object::operator==(const Object& other) const
     {
 
-        /*
-         * compare compressed JSON
-         */
-        return toString() == other.toString();
+        return equals(other);
     }
 
     bool
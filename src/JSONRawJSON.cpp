@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <JSON/cJSON/cJSON.h>
+#include <JSON/RawJSON.h>
+
+namespace JSON
+{
+
+    RawJSON::RawJSON(const std::string& text, bool trusted)
+        : m_text(text)
+    {
+        check(trusted);
+    }
+
+    RawJSON::RawJSON(const char* text, bool trusted)
+        : m_text(text == NULL ? "" : text)
+    {
+        check(trusted);
+    }
+
+    void
+    RawJSON::check(bool trusted) const
+    {
+        // even trusted text must print as a value, or the document around it breaks
+        if(m_text.find_first_not_of(" \t\r\n") == std::string::npos)
+            THROW_MSG(Exception, "empty raw JSON");
+        if(!trusted && !cJSON_Validate(m_text.c_str()))
+            THROW_MSG(Exception, "invalid raw JSON: " << m_text);
+    }
+
+} /* namespace JSON */
@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <JSON/JSON.h>
+#include <JSON/Object.h>
+
+namespace JSON
+{
+    using namespace std;
+
+    static void
+    unmapSnapshot(void* image, size_t size)
+    {
+        munmap(image, size);
+    }
+
+    void
+    JSON::writeSnapshot(const string& path) const
+    {
+        JTRACE;
+
+        if(0 == m_node)
+            THROW_MSG(Exception, "JSON node NULL");
+
+        size_t size = 0;
+        void* image = cJSON_Snapshot(m_node, &size);
+        if(0 == image)
+            THROW_MSG(Exception, "no memory while writing snapshot");
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if(0 == file)
+        {
+            int error = errno;
+            cJSON_free(image);
+            THROW_MSG(Exception, "unable to create snapshot " << path << ": " << strerror(error));
+        }
+
+        bool written = fwrite(image, 1, size, file) == size;
+        written = 0 == fclose(file) && written;
+        cJSON_free(image);
+
+        if(!written)
+            THROW_MSG(Exception, "unable to write snapshot " << path);
+    }
+
+    void
+    JSON::mapSnapshot(const string& path)
+    {
+        JTRACE;
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0)
+            THROW_MSG(Exception, "unable to open snapshot " << path << ": " << strerror(errno));
+
+        struct stat st;
+        if(0 != fstat(fd, &st) || st.st_size <= 0)
+        {
+            close(fd);
+            THROW_MSG(Exception, "not a JSON snapshot: " << path);
+        }
+
+        size_t size = st.st_size;
+        void* image = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        close(fd);
+        if(MAP_FAILED == image)
+            THROW_MSG(Exception, "unable to map snapshot " << path << ": " << strerror(error));
+
+        /*
+         * only the pages of the nodes, indexes and tables are made writable, to turn
+         * their offsets into pointers, the keys and strings stay read only and
+         * shared with every other process mapping the file
+         */
+        size_t writable = cJSON_SnapshotWritable(image, size);
+        if(0 != writable)
+        {
+            size_t page = sysconf(_SC_PAGESIZE);
+            writable = (writable + page - 1) / page * page;
+            if(0 != mprotect(image, writable < size ? writable : size, PROT_READ | PROT_WRITE))
+            {
+                error = errno;
+                munmap(image, size);
+                THROW_MSG(Exception, "unable to map snapshot " << path << ": " << strerror(error));
+            }
+        }
+
+        cJSON* root = cJSON_LoadSnapshot(image, size, unmapSnapshot);
+        if(0 == root)
+        {
+            munmap(image, size);
+            THROW_MSG(Exception, "not a JSON snapshot: " << path);
+        }
+
+        own(root);
+    }
+
+    Object
+    Object::mapSnapshot(const string& path)
+    {
+        JTRACE;
+
+        Object obj(JSON::JNONE);
+        obj.JSON::mapSnapshot(path);
+
+        if(obj.JSON::getType() != JSON::JOBJECT)
+            THROW_MSG(Exception, "snapshot is not a JSON object: " << path);
+
+        return obj;
+    }
+}
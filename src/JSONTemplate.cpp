@@ -0,0 +1,364 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cstring>
+
+#include <JSON/JSON.h>
+#include <JSON/Template.h>
+#include <JSON/Writer.h>
+
+namespace JSON
+{
+    using namespace std;
+
+    Template::Values::Values(const Template& tpl)
+        : m_template(tpl)
+        , m_values(tpl.slots())
+    {
+    }
+
+    Template::Values::Value&
+    Template::Values::slot(int index, SlotType type)
+    {
+        SlotType slotType = m_template.getType(index);
+
+        bool compatible = slotType == type
+            || (type == TINTEGER && slotType == TDOUBLE)
+            || (type == TSTRING && slotType == TJSON);
+
+        if(!compatible)
+            THROW_MSG(Exception, "template value does not match slot type: ${" << m_template.m_slots[index].name << "}");
+
+        Value& value = m_values[index];
+        value.isSet = true;
+        return value;
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, bool value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, bool value)
+    {
+        slot(index, TBOOLEAN).boolean = value;
+        return *this;
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, double value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, double value)
+    {
+        slot(index, TDOUBLE).number = value;
+        return *this;
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, const string& value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, const string& value)
+    {
+        /*
+         * text for a json slot is copied to the output as is, so it is held to
+         * the same check as an untrusted RawJSON
+         */
+        if(m_template.getType(index) == TJSON)
+            return set(index, RawJSON(value));
+
+        slot(index, TSTRING).text = value;
+        return *this;
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, const char* value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, const char* value)
+    {
+        if(0 == value)
+            THROW_MSG(Exception, "template value NULL for slot: " << index);
+        return set(index, string(value));
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, const JSON& value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, const JSON& value)
+    {
+        slot(index, TJSON).text = value.toString();
+        return *this;
+    }
+
+    Template::Values&
+    Template::Values::set(const string& name, const RawJSON& value)
+    {
+        return set(m_template.slot(name), value);
+    }
+
+    Template::Values&
+    Template::Values::set(int index, const RawJSON& value)
+    {
+        slot(index, TJSON).text = value.str();
+        return *this;
+    }
+
+    void
+    Template::Values::clear()
+    {
+        for(vector<Value>::iterator i = m_values.begin(); i != m_values.end(); ++i)
+            i->isSet = false;
+    }
+
+    Template::Template(const string& skeleton)
+    {
+        cJSON* root = cJSON_Parse(skeleton.c_str());
+        if(0 == root)
+            THROW_MSG(Exception, "parse error: " << skeleton);
+
+        size_t mark = 0;
+        try
+        {
+            compile(root, mark);
+        }
+        catch(...)
+        {
+            cJSON_Delete(root);
+            throw;
+        }
+        cJSON_Delete(root);
+
+        /*
+         * trailing literal run
+         */
+        Part part = { m_text.size() - mark, -1 };
+        m_parts.push_back(part);
+    }
+
+    bool
+    Template::placeholder(const cJSON* item, size_t& mark)
+    {
+        const char* str = item->valuestring;
+        size_t len = cJSON_GetStringLength(item);
+
+        if(len < 4 || str[0] != '$' || str[1] != '{' || str[len - 1] != '}')
+            return false;
+
+        string name(str + 2, len - 3);
+        SlotType type = TSTRING;
+
+        string::size_type colon = name.find(':');
+        if(colon != string::npos)
+        {
+            string typeName = name.substr(colon + 1);
+            name.erase(colon);
+
+            if(typeName == "string")
+                type = TSTRING;
+            else if(typeName == "int")
+                type = TINTEGER;
+            else if(typeName == "double")
+                type = TDOUBLE;
+            else if(typeName == "bool")
+                type = TBOOLEAN;
+            else if(typeName == "json")
+                type = TJSON;
+            else
+                THROW_MSG(Exception, "unknown template placeholder type: " << str);
+        }
+
+        if(name.empty())
+            THROW_MSG(Exception, "template placeholder has no name: " << str);
+
+        int index;
+        map<string, int>::const_iterator i = m_names.find(name);
+        if(i == m_names.end())
+        {
+            index = static_cast<int>(m_slots.size());
+            Slot slot = { name, type };
+            m_slots.push_back(slot);
+            m_names[name] = index;
+        }
+        else
+        {
+            index = i->second;
+            if(m_slots[index].type != type)
+                THROW_MSG(Exception, "template placeholder used with different types: ${" << name << "}");
+        }
+
+        Part part = { m_text.size() - mark, index };
+        m_parts.push_back(part);
+        mark = m_text.size();
+        return true;
+    }
+
+    void
+    Template::compile(const cJSON* item, size_t& mark)
+    {
+        Writer writer(m_text);
+
+        switch(item->type & 255)
+        {
+        case cJSON_NULL:
+            writer.null();
+            break;
+        case cJSON_False:
+            writer.boolean(false);
+            break;
+        case cJSON_True:
+            writer.boolean(true);
+            break;
+        case cJSON_Number:
+            {
+                char* json = cJSON_PrintUnformatted(const_cast<cJSON*>(item));
+                writer.raw(json, strlen(json));
+                cJSON_free(json);
+            }
+            break;
+        case cJSON_String:
+            if(!placeholder(item, mark))
+                writer.string(item->valuestring, cJSON_GetStringLength(item));
+            break;
+        case cJSON_Array:
+            writer.raw("[", 1);
+            for(const cJSON* child = cJSON_GetChild(const_cast<cJSON*>(item)); child; child = child->next)
+            {
+                if(child->prev)
+                    writer.raw(",", 1);
+                compile(child, mark);
+            }
+            writer.raw("]", 1);
+            break;
+        case cJSON_Object:
+            writer.raw("{", 1);
+            for(const cJSON* child = item->child; child; child = child->next)
+            {
+                if(child != item->child)
+                    writer.raw(",", 1);
+                writer.string(child->string, cJSON_GetKeyLength(child));
+                writer.raw(":", 1);
+                compile(child, mark);
+            }
+            writer.raw("}", 1);
+            break;
+        }
+    }
+
+    size_t
+    Template::slots() const
+    {
+        return m_slots.size();
+    }
+
+    int
+    Template::slot(const string& name) const
+    {
+        map<string, int>::const_iterator i = m_names.find(name);
+        if(i == m_names.end())
+            THROW_MSG(Exception, "no such template placeholder: ${" << name << "}");
+
+        return i->second;
+    }
+
+    Template::SlotType
+    Template::getType(int index) const
+    {
+        if(index < 0 || index >= static_cast<int>(m_slots.size()))
+            THROW_MSG(Exception, "template slot index out of range: " << index);
+
+        return m_slots[index].type;
+    }
+
+    void
+    Template::render(const Values& values, string& out) const
+    {
+        if(&values.m_template != this)
+            THROW_MSG(Exception, "template values belong to a different template");
+
+        const char* text = m_text.data();
+        out.reserve(out.size() + m_text.size() + 16 * m_slots.size());
+
+        Writer writer(out);
+        for(vector<Part>::const_iterator part = m_parts.begin(); part != m_parts.end(); ++part)
+        {
+            writer.raw(text, part->length);
+            text += part->length;
+
+            if(part->slot < 0)
+                continue;
+
+            const Values::Value& value = values.m_values[part->slot];
+            if(!value.isSet)
+                THROW_MSG(Exception, "template value not set: ${" << m_slots[part->slot].name << "}");
+
+            switch(m_slots[part->slot].type)
+            {
+            case TSTRING:
+                writer.string(value.text);
+                break;
+            case TINTEGER:
+                writer.number(value.integer);
+                break;
+            case TDOUBLE:
+                writer.number(value.number);
+                break;
+            case TBOOLEAN:
+                writer.boolean(value.boolean);
+                break;
+            case TJSON:
+                writer.raw(value.text.data(), value.text.size());
+                break;
+            }
+        }
+    }
+
+    string
+    Template::render(const Values& values) const
+    {
+        string out;
+        render(values, out);
+        return out;
+    }
+
+} /* namespace JSON */
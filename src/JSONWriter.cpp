@@ -0,0 +1,145 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+
+#include <JSON/Writer.h>
+
+namespace JSON
+{
+
+    using namespace std;
+
+    Writer::Writer(std::string& out)
+        : m_out(out)
+    {
+    }
+
+    Writer&
+    Writer::raw(const char* text, size_t length)
+    {
+        m_out.append(text, length);
+        return *this;
+    }
+
+    Writer&
+    Writer::string(const char* value, size_t length)
+    {
+        const char* end = value + length;
+        const char* run = value;
+
+        m_out += '\"';
+        for(const char* ptr = value; ptr < end; ++ptr)
+        {
+            unsigned char token = static_cast<unsigned char>(*ptr);
+            if(token > 31 && token != '\"' && token != '\\')
+                continue;
+
+            /*
+             * copy the run of characters that need no escaping in one go
+             */
+            m_out.append(run, ptr - run);
+            run = ptr + 1;
+
+            switch(token)
+            {
+            case '\\':  m_out.append("\\\\", 2); break;
+            case '\"':  m_out.append("\\\"", 2); break;
+            case '\b':  m_out.append("\\b", 2); break;
+            case '\f':  m_out.append("\\f", 2); break;
+            case '\n':  m_out.append("\\n", 2); break;
+            case '\r':  m_out.append("\\r", 2); break;
+            case '\t':  m_out.append("\\t", 2); break;
+            default:
+                {
+                    char buf[8];
+                    int len = snprintf(buf, sizeof(buf), "\\u%04x", token);
+                    m_out.append(buf, len);
+                }
+                break;
+            }
+        }
+        m_out.append(run, end - run);
+        m_out += '\"';
+        return *this;
+    }
+
+    Writer&
+    Writer::number(double value)
+    {
+        /*
+         * the same choice of format as print_number() in cJSON.c,
+         * which has no number for NaN or infinity either
+         */
+        if(!isfinite(value))
+            return null();
+
+        char buf[64];
+        int len;
+        if(value <= INT_MAX && value >= INT_MIN && fabs(static_cast<double>(static_cast<int64_t>(value)) - value) <= DBL_EPSILON)
+            len = snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+        else if(fabs(floor(value) - value) <= DBL_EPSILON && fabs(value) < 1.0e60)
+            len = snprintf(buf, sizeof(buf), "%.0f", value);
+        else if(fabs(value) < 1.0e-6 || fabs(value) > 1.0e9)
+            len = snprintf(buf, sizeof(buf), "%e", value);
+        else
+            len = snprintf(buf, sizeof(buf), "%f", value);
+
+        m_out.append(buf, len);
+        return *this;
+    }
+
+    Writer&
+    Writer::number(int64_t value)
+    {
+        char buf[24];
+        int len = snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(value));
+        m_out.append(buf, len);
+        return *this;
+    }
+
+    Writer&
+    Writer::boolean(bool value)
+    {
+        if(value)
+            m_out.append("true", 4);
+        else
+            m_out.append("false", 5);
+        return *this;
+    }
+
+    Writer&
+    Writer::null()
+    {
+        m_out.append("null", 4);
+        return *this;
+    }
+
+} /* namespace JSON */
@@ -30,17 +30,33 @@
 #include <float.h>
 #include <limits.h>
 #include <ctype.h>
+#include <stddef.h>
+#if defined(__GNUC__)
+#include <pthread.h>
+#endif
 #include <JSON/cJSON/cJSON.h>
 
 static const char *ep;
 
 const char *cJSON_GetErrorPtr(void) {return ep;}
 
+/* ASCII case folding for keys, tolower() depends on the locale. */
+static int cJSON_fold(int c) {return (c>='A' && c<='Z')?c+('a'-'A'):c;}
+
 static int cJSON_strcasecmp(const char *s1,const char *s2)
 {
 	if (!s1) return (s1==s2)?0:1;if (!s2) return 1;
-	for(; tolower(*s1) == tolower(*s2); ++s1, ++s2)	if(*s1 == 0)	return 0;
-	return tolower(*(const unsigned char *)s1) - tolower(*(const unsigned char *)s2);
+	for(; cJSON_fold(*(const unsigned char *)s1) == cJSON_fold(*(const unsigned char *)s2); ++s1, ++s2)	if(*s1 == 0)	return 0;
+	return cJSON_fold(*(const unsigned char *)s1) - cJSON_fold(*(const unsigned char *)s2);
+}
+
+/* FNV-1a of the case folded key, so exact and case insensitive lookups share one hash. */
+static unsigned int cJSON_hash(const char *str,size_t *len)
+{
+	const unsigned char *p=(const unsigned char*)str;unsigned int h=2166136261u;
+	while (*p) h=(h^(unsigned int)cJSON_fold(*p++))*16777619u;
+	*len=(size_t)(p-(const unsigned char*)str);
+	return h;
 }
 
 void *(*cJSON_malloc)(size_t sz) = malloc;
@@ -77,6 +93,499 @@ static cJSON *cJSON_New_Item(void)
 	return node;
 }
 
+/* Where a short key of item goes: the value field its type leaves unused. */
+static char *key_storage(cJSON *item,size_t *room)
+{
+	switch (item->type&255)
+	{
+		case cJSON_Number:	*room=sizeof(item->valuestring);return (char*)&item->valuestring;
+		case cJSON_Array:
+		case cJSON_Object:	*room=sizeof(item->valueint);return (char*)&item->valueint;
+		default:			*room=sizeof(item->valuedouble);return (char*)&item->valuedouble;
+	}
+}
+/* Storage for a string of len bytes and its terminator, in item when short, else from cJSON_malloc. A key is placed by
+the type of item, so it is set once the type is. */
+typedef char cJSON_value_storage[sizeof(((cJSON*)0)->valueint)>=cJSON_INLINE_STRING && sizeof(((cJSON*)0)->valuedouble)>=cJSON_INLINE_STRING?1:-1];
+static char *string_storage(cJSON *item,size_t len,int key)
+{
+	size_t room;char *slot;
+	if (key) {slot=key_storage(item,&room);if (len>=room) return (char*)cJSON_malloc(len+1);item->type|=cJSON_StringIsInline;return slot;}
+	if (len>=cJSON_INLINE_STRING-1) return (char*)cJSON_malloc(len+1);	/* the last byte holds the length */
+	item->type|=cJSON_ValueIsInline;return (char*)&item->valueint;
+}
+/* The byte length of a value string is kept in valueint, or in the last byte of the storage of an inline one. */
+static void string_set_length(cJSON *item,size_t len)
+{
+	if (item->type&cJSON_ValueIsInline) ((unsigned char*)&item->valueint)[cJSON_INLINE_STRING-1]=(unsigned char)len;
+	else item->valueint=(int64_t)len;
+}
+static size_t string_length(const cJSON *item)
+{
+	if (item->type&cJSON_ValueIsInline) return ((const unsigned char*)&item->valueint)[cJSON_INLINE_STRING-1];
+	return (size_t)item->valueint;
+}
+/* Arrays and objects: their valuedouble is their index, and a short key is kept in their valueint. */
+static int is_container(const cJSON *item)	{return (item->type&255)==cJSON_Array || (item->type&255)==cJSON_Object;}
+/* The text of a String or Raw item. Other items may hold a key or packed numbers in valuestring. */
+static char *value_text(const cJSON *item)
+{
+	return (item->type&255)==cJSON_String || (item->type&255)==cJSON_Raw?item->valuestring:0;
+}
+size_t cJSON_GetStringLength(const cJSON *item)
+{
+	if (!item || !value_text(item)) return 0;
+	return string_length(item);
+}
+/* Copy len bytes of str to the key or the value string of item. */
+static char *string_copy(cJSON *item,const char *str,size_t len,int key)
+{
+	char *copy=string_storage(item,len,key);
+	if (!copy) return 0;
+	memcpy(copy,str,len);copy[len]=0;
+	if (!key) string_set_length(item,len);
+	return copy;
+}
+
+/* Update keylen after string is set. A key too long for it is measured when needed. */
+static void cJSON_SetKey(cJSON *item)
+{
+	size_t len=item->string?strlen(item->string):0;
+	item->keylen=len<=UINT_MAX?(unsigned int)len:0;
+}
+
+/* keylen of item, worked out from string when it was set by hand and left 0. The hash is that of the key tables, ASCII
+case folded. */
+static size_t key_length(const cJSON *item)	{return item->keylen || !item->string?item->keylen:strlen(item->string);}
+static unsigned int key_hash(const cJSON *item)	{size_t len;return item->string?cJSON_hash(item->string,&len):0;}
+size_t cJSON_GetKeyLength(const cJSON *item)	{return item?key_length(item):0;}
+
+/* Arrays and objects with at least this many children get an index the first time an access has to walk that far. */
+#define cJSON_INDEX_THRESHOLD 16
+
+/* Bookkeeping for the children of a large array or object, kept in step by the functions that add, detach and replace children. */
+struct cJSON_Index {
+	int count;					/* number of children */
+	cJSON *tail;				/* last child */
+	cJSON *cursor;int at;		/* last child reached by walking to a position and that position, cursor is 0 when unknown */
+	cJSON **items;int capacity;int valid;	/* children by position, current while valid */
+	cJSON **table;size_t mask;size_t used;	/* members by key hash, probed linearly, used includes removed slots.
+	                                           Members are inserted in list order, so of several case insensitive
+	                                           matches the one found first is the first in the list. */
+	int lock;					/* held by a reader filling in the position table, key table, cursor or hash */
+	uint64_t changes;			/* children added, detached or replaced since the index was made */
+	uint64_t hash,hashseed,hashgen;int hashordered;	/* cJSON_Hash of the subtree, current while hashgen is changes+1 */
+	int frozen;					/* built by cJSON_Freeze inside the block, freed with it */
+};
+
+/* Header of the single allocation holding a frozen tree: the nodes in depth first order, the indexes of the
+   large containers with their position and key tables, then the keys and strings. A snapshot is a block
+   written out with its pointers made offsets from its start. */
+struct cJSON_Block {
+	char magic[8];				/* cJSON_SNAPSHOT in a snapshot, zero in a block from cJSON_Freeze */
+	uint32_t version,layout;	/* snapshot format, and sizes that must match the reader's, read back wrong in the other byte order */
+	uint64_t size;				/* bytes, including this header */
+	uint64_t nodes,indexes,slots;	/* numbers of nodes, the root first, indexes, and position and key table slots */
+	void (*release)(void *image,size_t size);	/* called by cJSON_Delete for a loaded snapshot */
+};
+
+#define cJSON_SNAPSHOT "cJSONsnp"
+#define cJSON_SNAPSHOT_VERSION 2
+#define cJSON_SNAPSHOT_LAYOUT ((uint32_t)(sizeof(cJSON)|sizeof(struct cJSON_Index)<<8|sizeof(void*)<<16))
+
+/* Readers build indexes lazily, so a tree that is only read may be read by several threads at once.
+   An index is published once it is complete; without GCC style atomics readers must be serialized by the caller. */
+#if defined(__GNUC__)
+#define cJSON_acquire(p)		__atomic_load_n(p,__ATOMIC_ACQUIRE)
+#define cJSON_increment(p)		__atomic_add_fetch(p,1,__ATOMIC_RELAXED)
+#define cJSON_release(p,v)		__atomic_store_n(p,v,__ATOMIC_RELEASE)
+#define cJSON_publish(p,o,v)	__atomic_compare_exchange_n(p,&(o),v,0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)
+#define cJSON_decrement(p)		__atomic_sub_fetch(p,1,__ATOMIC_ACQ_REL)
+#define cJSON_thread			__thread
+static void index_lock(struct cJSON_Index *index)	{while (__atomic_exchange_n(&index->lock,1,__ATOMIC_ACQUIRE)) while (__atomic_load_n(&index->lock,__ATOMIC_RELAXED));}
+static void index_unlock(struct cJSON_Index *index)	{__atomic_store_n(&index->lock,0,__ATOMIC_RELEASE);}
+#else
+#define cJSON_acquire(p)		(*(p))
+#define cJSON_increment(p)		(++*(p))
+#define cJSON_release(p,v)		(*(p)=(v))
+#define cJSON_publish(p,o,v)	(*(p)==(o)?(*(p)=(v),1):((o)=*(p),0))
+#define cJSON_decrement(p)		(--*(p))
+#define cJSON_thread
+static void index_lock(struct cJSON_Index *index)	{(void)index;}
+static void index_unlock(struct cJSON_Index *index)	{(void)index;}
+#endif
+
+/* Marks the key table slot of a removed member. Its string is 0 so it never matches. */
+static cJSON cJSON_removed;
+
+/* Interned keys: one immutable, reference counted copy of a key shared by every item named with it. string points at
+   text and the item is flagged cJSON_StringIsInterned. */
+struct cJSON_Key {unsigned long refs;unsigned int hash;size_t len;char text[];};
+/* An interning table, one per parse or per thread, holding a reference to each of its keys. */
+struct cJSON_Keys {struct cJSON_Key **slots;size_t mask,used;char *scratch;size_t scratch_size;};
+/* The table of the parse under way, and the table keys given by this thread are interned through, see cJSON_InternKeys. */
+static cJSON_thread struct cJSON_Keys *parse_keys;
+static cJSON_thread struct cJSON_Keys *thread_keys;
+/* Set while cJSON_ParsePacked parses: long runs of numbers are packed. */
+static cJSON_thread int parse_pack;
+
+#define key_of(str) ((struct cJSON_Key*)(void*)((str)-offsetof(struct cJSON_Key,text)))
+static void key_release(char *str)	{struct cJSON_Key *k=key_of(str);if (!cJSON_decrement(&k->refs)) cJSON_free(k);}
+
+/* The key str of len bytes from table keys, added if new, with a reference for the caller. 0 without memory. */
+static struct cJSON_Key *keys_intern(struct cJSON_Keys *keys,const char *str,size_t len,unsigned int hash)
+{
+	struct cJSON_Key *k,**slots;size_t i,j;
+	if (keys->used*2>=keys->mask)
+	{
+		size_t mask=keys->slots?keys->mask*2+1:63;
+		if (!(slots=(struct cJSON_Key**)cJSON_malloc((mask+1)*sizeof(*slots)))) return 0;
+		memset(slots,0,(mask+1)*sizeof(*slots));
+		for (j=0;keys->slots && j<=keys->mask;j++) if ((k=keys->slots[j])) {for (i=k->hash&mask;slots[i];i=(i+1)&mask);slots[i]=k;}
+		cJSON_free(keys->slots);keys->slots=slots;keys->mask=mask;
+	}
+	for (i=hash&keys->mask;(k=keys->slots[i]);i=(i+1)&keys->mask)
+		if (k->hash==hash && k->len==len && !memcmp(k->text,str,len)) {cJSON_increment(&k->refs);return k;}
+	if (!(k=(struct cJSON_Key*)cJSON_malloc(offsetof(struct cJSON_Key,text)+len+1))) return 0;
+	k->refs=2;k->hash=hash;k->len=len;memcpy(k->text,str,len);k->text[len]=0;
+	keys->slots[i]=k;keys->used++;
+	return k;
+}
+
+/* Drop the references of table keys and its buffers. Keys in use by items live on. */
+static void keys_clear(struct cJSON_Keys *keys)
+{
+	size_t i;
+	for (i=0;keys->slots && i<=keys->mask;i++) if (keys->slots[i]) key_release(keys->slots[i]->text);
+	cJSON_free(keys->slots);cJSON_free(keys->scratch);memset(keys,0,sizeof(*keys));
+}
+
+/* A buffer for a key of up to len bytes about to be interned. */
+static char *keys_scratch(struct cJSON_Keys *keys,size_t len)
+{
+	char *scratch;
+	if (len<keys->scratch_size) return keys->scratch;
+	if (!(scratch=(char*)cJSON_malloc(len+64))) return 0;
+	cJSON_free(keys->scratch);keys->scratch=scratch;keys->scratch_size=len+64;
+	return scratch;
+}
+
+/* Name item with the key str, interned in keys. Returns 0 without memory. */
+static int key_intern(cJSON *item,struct cJSON_Keys *keys,const char *str)
+{
+	size_t len;unsigned int hash=cJSON_hash(str,&len);struct cJSON_Key *k=keys_intern(keys,str,len,hash);
+	if (!k) return 0;
+	item->string=k->text;item->keylen=k->len<=UINT_MAX?(unsigned int)k->len:0;item->type|=cJSON_StringIsInterned;
+	return 1;
+}
+
+/* Release the key of item, whichever way it is held. */
+static void key_free(cJSON *item)
+{
+	if (item->type&cJSON_StringIsInterned) key_release(item->string);
+	else if (item->string && !(item->type&cJSON_StringIsInline)) cJSON_free(item->string);
+	item->type&=~(cJSON_StringIsInterned|cJSON_StringIsInline);item->string=0;
+}
+
+/* The table of a thread is freed when the thread ends, if it has not turned interning off by then. */
+#if defined(__GNUC__)
+static pthread_key_t keys_exit;static pthread_once_t keys_exit_once=PTHREAD_ONCE_INIT;static int keys_exit_ready;
+static void keys_exit_free(void *keys)	{keys_clear((struct cJSON_Keys*)keys);cJSON_free(keys);thread_keys=0;}
+static void keys_exit_create(void)		{keys_exit_ready=!pthread_key_create(&keys_exit,keys_exit_free);}
+static int keys_on_exit(struct cJSON_Keys *keys)	{pthread_once(&keys_exit_once,keys_exit_create);return keys_exit_ready && !pthread_setspecific(keys_exit,keys);}
+#else
+static int keys_on_exit(struct cJSON_Keys *keys)	{(void)keys;return 1;}
+#endif
+
+int cJSON_InternKeys(int enable)
+{
+	if (!enable) {if (thread_keys) keys_on_exit(0),keys_clear(thread_keys),cJSON_free(thread_keys),thread_keys=0;return 1;}
+	if (thread_keys) return 1;
+	if (!(thread_keys=(struct cJSON_Keys*)cJSON_malloc(sizeof(*thread_keys)))) return 0;
+	memset(thread_keys,0,sizeof(*thread_keys));
+	if (!keys_on_exit(thread_keys)) {cJSON_free(thread_keys);thread_keys=0;}
+	return thread_keys!=0;
+}
+
+/* The index of item. Only arrays and objects have one, it shares its storage with valuedouble. */
+static struct cJSON_Index *index_of(cJSON *item)
+{
+	return is_container(item)?cJSON_acquire(&item->index):0;
+}
+
+static void index_free(cJSON *parent)
+{
+	if (!index_of(parent)) return;
+	cJSON_free(parent->index->items);cJSON_free(parent->index->table);cJSON_free(parent->index);parent->index=0;
+}
+
+/* Index parent, which has count children ending with tail. References are not indexed, their children belong to someone else. */
+static struct cJSON_Index *index_new(cJSON *parent,int count,cJSON *tail)
+{
+	struct cJSON_Index *index,*current=0;
+	if ((index=index_of(parent))) return index;
+	if ((parent->type&cJSON_IsReference) || !is_container(parent)) return 0;
+	if (!(index=(struct cJSON_Index*)cJSON_malloc(sizeof(struct cJSON_Index)))) return 0;
+	memset(index,0,sizeof(struct cJSON_Index));index->count=count;index->tail=tail;
+	if (cJSON_publish(&parent->index,current,index)) return index;
+	cJSON_free(index);return current;	/* another reader got there first */
+}
+
+/* Fill the position table, with room to append. Returns 0 without memory. */
+static int items_build(cJSON *parent,struct cJSON_Index *index)
+{
+	cJSON *c;int i=0;
+	if (index->capacity<index->count+1)
+	{
+		int capacity=index->count+index->count/2+1;
+		cJSON **items=(cJSON**)cJSON_malloc(capacity*sizeof(cJSON*));
+		if (!items) return 0;
+		cJSON_free(index->items);index->items=items;index->capacity=capacity;
+	}
+	for (c=parent->child;c;c=c->next) index->items[i++]=c;
+	cJSON_release(&index->valid,1);
+	return 1;
+}
+
+static void keys_insert(cJSON **table,size_t mask,cJSON *item)
+{
+	size_t i=key_hash(item)&mask;
+	while (table[i]) i=(i+1)&mask;
+	table[i]=item;
+}
+
+/* Slots in a key table for count members, keeping it at most half full. */
+static size_t keys_size(int count)
+{
+	size_t size=cJSON_INDEX_THRESHOLD*2;
+	while (size<((size_t)count+1)*2) size<<=1;
+	return size;
+}
+
+/* (Re)build the key table, publishing it once filled. Without memory lookups walk the list. */
+static void keys_build(cJSON *object,struct cJSON_Index *index)
+{
+	size_t size=keys_size(index->count),used=0;cJSON **table;cJSON *c;
+	cJSON_free(index->table);index->table=0;
+	if (!(table=(cJSON**)cJSON_malloc(size*sizeof(cJSON*)))) return;
+	memset(table,0,size*sizeof(cJSON*));
+	for (c=object->child;c;c=c->next) if (c->string) keys_insert(table,size-1,c),used++;
+	index->mask=size-1;index->used=used;
+	cJSON_release(&index->table,table);
+}
+
+/* Keep the index in step with a child appended to the list. */
+static void index_add(cJSON *parent,cJSON *item)
+{
+	struct cJSON_Index *index=index_of(parent);
+	if (!index) return;
+	index->count++;index->tail=item;
+	if (index->valid && index->count>index->capacity)
+	{
+		int capacity=index->capacity*2;
+		cJSON **items=(cJSON**)cJSON_malloc(capacity*sizeof(cJSON*));
+		if (items) {memcpy(items,index->items,(index->count-1)*sizeof(cJSON*));cJSON_free(index->items);index->items=items;index->capacity=capacity;}
+		else index->valid=0;
+	}
+	if (index->valid) index->items[index->count-1]=item;
+	if (index->table && item->string)
+	{
+		if ((index->used+1)*2>index->mask+1) keys_build(parent,index);
+		else keys_insert(index->table,index->mask,item),index->used++;
+	}
+}
+
+/* Keep the index in step with a child about to be unlinked from position pos, -1 if not known. */
+static void index_remove(cJSON *parent,cJSON *item,int pos)
+{
+	struct cJSON_Index *index=index_of(parent);size_t i;
+	if (!index) return;
+	index->count--;
+	if (index->tail==item) index->tail=item->prev;
+	if (index->valid)
+	{
+		if (pos<0) index->valid=0;
+		else memmove(index->items+pos,index->items+pos+1,(index->count-pos)*sizeof(cJSON*));
+	}
+	if (index->cursor)
+	{
+		if (pos<0) index->cursor=0;
+		else if (pos<index->at) index->at--;
+		else if (pos==index->at) index->cursor=item->next;
+	}
+	if (index->table && item->string)
+		for (i=key_hash(item)&index->mask;index->table[i];i=(i+1)&index->mask)
+			if (index->table[i]==item) {index->table[i]=&cJSON_removed;break;}
+}
+
+/* Keep the index in step with newitem taking the place of item at position pos, -1 if not known. */
+static void index_replace(cJSON *parent,cJSON *item,cJSON *newitem,int pos)
+{
+	struct cJSON_Index *index=index_of(parent);size_t i;
+	if (!index) return;
+	if (index->valid)
+	{
+		if (pos<0) index->valid=0;
+		else index->items[pos]=newitem;
+	}
+	if (index->cursor==item) index->cursor=newitem;
+	if (index->tail==item) index->tail=newitem;
+	if (!index->table) return;
+	if (!item->string || !newitem->string || key_hash(item)!=key_hash(newitem)) {cJSON_free(index->table);index->table=0;return;}
+	for (i=key_hash(item)&index->mask;index->table[i];i=(i+1)&index->mask)
+		if (index->table[i]==item) {index->table[i]=newitem;break;}
+}
+
+/* The numbers of a packed array, held in its valuestring until its nodes are made. */
+struct cJSON_Packed {
+	int count,capacity;			/* values held and room for */
+	int integers;				/* values are int64_t rather than double */
+	union {double d;int64_t i;} values[];
+};
+
+#define packed_size(capacity) (offsetof(struct cJSON_Packed,values)+(size_t)(capacity)*sizeof(((struct cJSON_Packed*)0)->values[0]))
+
+static struct cJSON_Packed *packed_new(int capacity,int integers)
+{
+	struct cJSON_Packed *p=(struct cJSON_Packed*)cJSON_malloc(packed_size(capacity));
+	if (p) p->count=0,p->capacity=capacity,p->integers=integers;
+	return p;
+}
+
+/* Copy p with room for capacity values. Returns 0 without memory. */
+static struct cJSON_Packed *packed_copy(const struct cJSON_Packed *p,int capacity)
+{
+	struct cJSON_Packed *copy=packed_new(capacity,p->integers);
+	if (!copy) return 0;
+	memcpy(copy->values,p->values,(size_t)p->count*sizeof(p->values[0]));copy->count=p->count;
+	return copy;
+}
+
+/* Move p to room for capacity values. Returns 0 without memory, p is then kept. */
+static struct cJSON_Packed *packed_resize(struct cJSON_Packed *p,int capacity)
+{
+	struct cJSON_Packed *copy=packed_copy(p,capacity);
+	if (copy) cJSON_free(p);
+	return copy;
+}
+
+/* The packed values of array, 0 unless it is packed and its nodes have not been made. */
+static struct cJSON_Packed *packed_of(cJSON *array)
+{
+	return ((array->type&cJSON_IsPacked) && !cJSON_acquire(&array->child))?(struct cJSON_Packed*)(void*)array->valuestring:0;
+}
+
+/* Set node to value i. */
+static void packed_get(const struct cJSON_Packed *p,int i,cJSON *node)
+{
+	node->type=cJSON_Number;
+	if (p->integers) node->valueint=p->values[i].i,node->valuedouble=(double)p->values[i].i;
+	else node->valuedouble=p->values[i].d,node->valueint=(int64_t)p->values[i].d;
+}
+
+/* A list of nodes holding the values. Returns 0 without memory. */
+static cJSON *packed_nodes(const struct cJSON_Packed *p)
+{
+	cJSON *first=0,*prev=0,*n;int i;
+	for (i=0;i<p->count;i++,prev=n)
+	{
+		if (!(n=cJSON_New_Item())) {cJSON_Delete(first);return 0;}
+		packed_get(p,i,n);
+		if (prev) prev->next=n,n->prev=prev; else first=n;
+	}
+	return first;
+}
+
+/* The nodes of a packed array are made the first time they are needed, and published like an index. The values are
+   kept for the readers that started with them. */
+cJSON *cJSON_GetChild(cJSON *item)
+{
+	cJSON *c,*current=0;
+	if (!item) return 0;
+	if (!(item->type&cJSON_IsPacked)) return item->child;
+	if ((c=cJSON_acquire(&item->child))) return c;
+	if (!(c=packed_nodes((struct cJSON_Packed*)(void*)item->valuestring))) return 0;
+	if (cJSON_publish(&item->child,current,c)) return c;
+	cJSON_Delete(c);return current;	/* another reader got there first */
+}
+
+/* Make a packed array ordinary before its children change. Returns 0 without memory. */
+static int unpack(cJSON *array)
+{
+	if (!(array->type&cJSON_IsPacked)) return 1;
+	if (!cJSON_GetChild(array)) return 0;
+	cJSON_free(array->valuestring);array->valuestring=0;array->type&=~cJSON_IsPacked;
+	return 1;
+}
+
+/* An array of count packed values for the caller to fill in. */
+static cJSON *packed_array(int count,int integers)
+{
+	cJSON *a=cJSON_New_Item();struct cJSON_Packed *p;
+	if (!a) return 0;
+	if (!(p=packed_new(count,integers))) {cJSON_free(a);return 0;}
+	p->count=count;a->type=cJSON_Array|cJSON_IsPacked;a->valuestring=(char*)p;
+	return a;
+}
+
+int cJSON_GetPackedItem(cJSON *array,int item,double *valuedouble,int64_t *valueint)
+{
+	struct cJSON_Packed *p;cJSON n;
+	if (!array || !(p=packed_of(array)) || item<0 || item>=p->count) return 0;
+	packed_get(p,item,&n);
+	if (valuedouble) *valuedouble=n.valuedouble;
+	if (valueint) *valueint=n.valueint;
+	return 1;
+}
+
+int cJSON_GetDoubleArray(cJSON *array,int start,double *numbers,int count)
+{
+	struct cJSON_Packed *p;cJSON *c;int i=0;
+	if (!array || start<0 || count<=0) return 0;
+	if ((p=packed_of(array)))
+	{
+		if (start>=p->count) return 0;
+		if (count>p->count-start) count=p->count-start;
+		if (!p->integers) memcpy(numbers,p->values+start,(size_t)count*sizeof(double));
+		else for (;i<count;i++) numbers[i]=(double)p->values[start+i].i;
+		return count;
+	}
+	for (c=cJSON_GetArrayItem(array,start);c && i<count && (c->type&255)==cJSON_Number;c=c->next) numbers[i++]=c->valuedouble;
+	return i;
+}
+
+int cJSON_GetInt64Array(cJSON *array,int start,int64_t *numbers,int count)
+{
+	struct cJSON_Packed *p;cJSON *c;int i=0;
+	if (!array || start<0 || count<=0) return 0;
+	if ((p=packed_of(array)))
+	{
+		if (start>=p->count) return 0;
+		if (count>p->count-start) count=p->count-start;
+		if (p->integers) memcpy(numbers,p->values+start,(size_t)count*sizeof(int64_t));
+		else for (;i<count;i++) numbers[i]=(int64_t)p->values[start+i].d;
+		return count;
+	}
+	for (c=cJSON_GetArrayItem(array,start);c && i<count && (c->type&255)==cJSON_Number;c=c->next) numbers[i++]=c->valueint;
+	return i;
+}
+
+/* Free a frozen tree, any index a reader built for one of its small containers and the nodes made for its packed arrays. */
+static void block_free(cJSON *root)
+{
+	struct cJSON_Block *block=(struct cJSON_Block*)root-1;cJSON *node=root;size_t i;
+	for (i=0;i<block->nodes;i++)
+	{
+		if (index_of(&node[i]) && !node[i].index->frozen) index_free(&node[i]);
+		if ((node[i].type&cJSON_IsPacked) && node[i].child) cJSON_Delete(node[i].child);
+	}
+	/* a key given to the root when it joined an object is not in the block */
+	if (root->type&cJSON_StringIsInterned) key_release(root->string);
+	else if (root->string && (root->string<(char*)block || root->string>=(char*)block+block->size)) cJSON_free(root->string);
+	if (!block->magic[0]) cJSON_free(block);
+	else if (block->release) block->release(block,(size_t)block->size);
+}
+
 /* Delete a cJSON structure. */
 void cJSON_Delete(cJSON *c)
 {
@@ -84,31 +593,56 @@ void cJSON_Delete(cJSON *c)
 	while (c)
 	{
 		next=c->next;
+		if (c->type&cJSON_IsFrozen) {block_free(c);c=next;continue;}
 		if (!(c->type&cJSON_IsReference) && c->child) cJSON_Delete(c->child),c->child=0;
-		if (!(c->type&cJSON_IsReference) && c->valuestring) cJSON_free(c->valuestring);
-		if (c->string) cJSON_free(c->string);
+		if (!(c->type&(cJSON_IsReference|cJSON_ValueIsInline)) && (value_text(c) || (c->type&cJSON_IsPacked))) cJSON_free(c->valuestring);
+		key_free(c);
+		index_free(c);
 		cJSON_free(c);
 		c=next;
 	}
 }
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static const char *parse_number(cJSON *item,const char *num)
+/* Scan the number at num into *value and, unless integer is NULL, *integer. Shared by the parser and cJSON_ScanNumber. */
+static const char *scan_number(const char *num,double *value,int64_t *integer)
 {
-	double n=0,sign=1,scale=0;int subscale=0,signsubscale=1;
+	double n=0,sign=1,scale=0;int subscale=0,signsubscale=1,digits=0;uint64_t m=0;
 
 	/* Could use sscanf for this? */
 	if (*num=='-') sign=-1,num++;	/* Has sign? */
 	if (*num=='0') num++;			/* is zero */
-	if (*num>='1' && *num<='9')	do	n=(n*10.0)+(*num++ -'0');	while (*num>='0' && *num<='9');	/* Number? */
+	if (*num>='1' && *num<='9')	do	m=m*10+(uint64_t)(*num-'0'),digits++,n=(n*10.0)+(*num++ -'0');	while (*num>='0' && *num<='9');	/* Number? */
 	if (*num=='.' && num[1]>='0' && num[1]<='9') {num++;		do	n=(n*10.0)+(*num++ -'0'),scale--; while (*num>='0' && *num<='9');}	/* Fractional part? */
 	if (*num=='e' || *num=='E')		/* Exponent? */
 	{	num++;if (*num=='+') num++;	else if (*num=='-') signsubscale=-1,num++;		/* With sign? */
-		while (*num>='0' && *num<='9') subscale=(subscale*10)+(*num++ - '0');	/* Number? */
+		while (*num>='0' && *num<='9') {if (subscale<100000) subscale=(subscale*10)+(*num - '0');num++;}	/* Number? Clamped, pow() saturates long before */
 	}
 
 	n=sign*n*pow(10.0,(scale+subscale*signsubscale));	/* number = +/- number.fraction * 10^+/- exponent */
 
+	*value=n;
+	/* integers that fit int64_t are exact, anything else is the double truncated */
+	if (integer)
+	{
+		if (digits<=19 && !scale && !subscale && m<=(uint64_t)INT64_MAX+(sign<0)) *integer=sign<0?(int64_t)(0-m):(int64_t)m;
+		else *integer=(n>=-9223372036854775808.0 && n<9223372036854775808.0)?(int64_t)n:0;
+	}
+	return num;
+}
+
+const char *cJSON_ScanNumber(const char *num,double *value,int64_t *integer)
+{
+	if (!num || !value) return 0;
+	if (*num=='-') {if (num[1]<'0' || num[1]>'9') return 0;}
+	else if (*num<'0' || *num>'9') return 0;
+	return scan_number(num,value,integer);
+}
+
+/* Parse the input text to generate a number, and populate the result into item. */
+static const char *parse_number(cJSON *item,const char *num)
+{
+	double n;
+	num=scan_number(num,&n,0);
 	item->valuedouble=n;
 	item->valueint=(int64_t)n;
 	item->type=cJSON_Number;
@@ -120,6 +654,7 @@ static char *print_number(cJSON *item)
 {
 	char *str;
 	double d=item->valuedouble;
+	if (d!=d || fabs(d)>DBL_MAX) return cJSON_strdup("null");	/* JSON has no NaN or infinity. */
 	if (fabs(((double)item->valueint)-d)<=DBL_EPSILON && d<=INT_MAX && d>=INT_MIN)
 	{
 		str=(char*)cJSON_malloc(21);	/* 2^64+1 can be represented in 21 chars. */
@@ -140,14 +675,17 @@ static char *print_number(cJSON *item)
 
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
-static const char *parse_string(cJSON *item,const char *str)
+/* The string becomes the key of item when key is set, else its value. */
+static const char *parse_string(cJSON *item,const char *str,int key)
 {
-	const char *ptr=str+1;char *ptr2;char *out;int len=0;unsigned uc,uc2;
+	const char *ptr=str+1;char *ptr2;char *out;int len=0;unsigned uc,uc2;struct cJSON_Keys *keys=0;
 	if (*str!='\"') {ep=str;return 0;}	/* not a string! */
 
 	while (*ptr!='\"' && *ptr && ++len) if (*ptr++ == '\\') ptr++;	/* Skip escaped quotes. */
 
-	out=(char*)cJSON_malloc(len+1);	/* This is how long we need for the string, roughly. */
+	/* This is how long we need for the string, roughly. A key too long for the node is interned from scratch. */
+	if (key && len>=cJSON_INLINE_STRING && (keys=thread_keys?thread_keys:parse_keys)) out=keys_scratch(keys,len);
+	else out=string_storage(item,len,key);
 	if (!out) return 0;
 
 	ptr=str+1;ptr2=out;
@@ -167,7 +705,7 @@ static const char *parse_string(cJSON *item,const char *str)
 				case 'u':	 /* transcode utf16 to utf8. */
 					sscanf(ptr+1,"%4x",&uc);ptr+=4;	/* get the unicode char. */
 
-					if ((uc>=0xDC00 && uc<=0xDFFF) || uc==0)	break;	/* check for invalid.	*/
+					if ((uc>=0xDC00 && uc<=0xDFFF) || (uc==0 && key))	break;	/* check for invalid, keys are C strings.	*/
 
 					if (uc>=0xD800 && uc<=0xDBFF)	/* UTF16 surrogate pairs.	*/
 					{
@@ -198,25 +736,26 @@ static const char *parse_string(cJSON *item,const char *str)
 	}
 	*ptr2=0;
 	if (*ptr=='\"') ptr++;
-	item->valuestring=out;
-	item->type=cJSON_String;
+	if (keys) {if (!key_intern(item,keys,out)) return 0;}
+	else if (key) {item->string=out;cJSON_SetKey(item);}
+	else {item->valuestring=out;item->type=cJSON_String|(item->type&cJSON_ValueIsInline);string_set_length(item,(size_t)(ptr2-out));}
 	return ptr;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
-static char *print_string_ptr(const char *str)
+/* Render the length bytes of str to an escaped version that can be printed. */
+static char *print_string_ptr(const char *str,size_t length)
 {
-	const char *ptr;char *ptr2,*out;int len=0;unsigned char token;
+	const char *ptr,*end=str+length;char *ptr2,*out;size_t len=length;unsigned char token;
 
 	if (!str) return cJSON_strdup("");
-	ptr=str;while ((token=*ptr) && ++len) {if (strchr("\"\\\b\f\n\r\t",token)) len++; else if (token<32) len+=5;ptr++;}
+	for (ptr=str;ptr<end;ptr++) {token=*ptr;if (token=='\"' || token=='\\' || token<32) len+=(token=='\b' || token=='\f' || token=='\n' || token=='\r' || token=='\t' || token>=32)?1:5;}
 
 	out=(char*)cJSON_malloc(len+3);
 	if (!out) return 0;
 
 	ptr2=out;ptr=str;
 	*ptr2++='\"';
-	while (*ptr)
+	while (ptr<end)
 	{
 		if ((unsigned char)*ptr>31 && *ptr!='\"' && *ptr!='\\') *ptr2++=*ptr++;
 		else
@@ -239,7 +778,7 @@ static char *print_string_ptr(const char *str)
 	return out;
 }
 /* Invote print_string_ptr (which is useful) on an item. */
-static char *print_string(cJSON *item)	{return print_string_ptr(item->valuestring);}
+static char *print_string(cJSON *item)	{return print_string_ptr(item->valuestring,string_length(item));}
 
 /* Predeclare these prototypes. */
 static const char *parse_value(cJSON *item,const char *value);
@@ -255,12 +794,15 @@ static const char *skip(const char *in) {while (in && *in && (unsigned char)*in<
 /* Parse an object - create a new root, and populate. */
 cJSON *cJSON_ParseWithOpts(const char *value,const char **return_parse_end,int require_null_terminated)
 {
-	const char *end=0;
+	const char *end=0;struct cJSON_Keys keys;
 	cJSON *c=cJSON_New_Item();
 	ep=0;
 	if (!c) return 0;       /* memory fail */
 
+	/* keys are interned per document */
+	memset(&keys,0,sizeof(keys));parse_keys=&keys;
 	end=parse_value(c,skip(value));
+	parse_keys=0;keys_clear(&keys);
 	if (!end)	{cJSON_Delete(c);return 0;}	/* parse failure. ep is set. */
 
 	/* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
@@ -270,6 +812,7 @@ cJSON *cJSON_ParseWithOpts(const char *value,const char **return_parse_end,int r
 }
 /* Default options for cJSON_Parse */
 cJSON *cJSON_Parse(const char *value) {return cJSON_ParseWithOpts(value,0,0);}
+cJSON *cJSON_ParsePacked(const char *value)	{cJSON *c;parse_pack=1;c=cJSON_ParseWithOpts(value,0,0);parse_pack=0;return c;}
 
 /* Render a cJSON item/entity/structure to text. */
 char *cJSON_Print(cJSON *item)				{return print_value(item,0,1);}
@@ -282,7 +825,7 @@ static const char *parse_value(cJSON *item,const char *value)
 	if (!strncmp(value,"null",4))	{ item->type=cJSON_NULL;  return value+4; }
 	if (!strncmp(value,"false",5))	{ item->type=cJSON_False; return value+5; }
 	if (!strncmp(value,"true",4))	{ item->type=cJSON_True; item->valueint=1;	return value+4; }
-	if (*value=='\"')				{ return parse_string(item,value); }
+	if (*value=='\"')				{ return parse_string(item,value,0); }
 	if (*value=='-' || (*value>='0' && *value<='9'))	{ return parse_number(item,value); }
 	if (*value=='[')				{ return parse_array(item,value); }
 	if (*value=='{')				{ return parse_object(item,value); }
@@ -304,10 +847,43 @@ static char *print_value(cJSON *item,int depth,int fmt)
 		case cJSON_String:	out=print_string(item);break;
 		case cJSON_Array:	out=print_array(item,depth,fmt);break;
 		case cJSON_Object:	out=print_object(item,depth,fmt);break;
+		case cJSON_Raw:		out=cJSON_strdup(item->valuestring?item->valuestring:"null");break;
 	}
 	return out;
 }
 
+/* Parse numbers into the packed values of array while the elements are numbers. Returns the text after the last one,
+   at the ']' or at the ',' before the first element that is not a number, or 0 on failure. */
+static const char *parse_numbers(cJSON *array,const char *value)
+{
+	struct cJSON_Packed *p=packed_new(cJSON_INDEX_THRESHOLD,0),*grown;double n;const char *next;
+	if (!p) return 0;
+	array->type|=cJSON_IsPacked;array->valuestring=(char*)p;
+	for (;;)
+	{
+		value=skip(scan_number(value,&n,0));
+		if (p->count==p->capacity)
+		{
+			if (!(grown=packed_resize(p,p->capacity*2))) return 0;
+			array->valuestring=(char*)(p=grown);
+		}
+		p->values[p->count++].d=n;
+		if (*value!=',') return value;
+		next=skip(value+1);
+		if (*next!='-' && (*next<'0' || *next>'9')) return value;
+		value=next;
+	}
+}
+
+/* Keep the values parsed into array packed if there are enough of them, trimming the spare room. */
+static int pack_fit(cJSON *array)
+{
+	struct cJSON_Packed *p=(struct cJSON_Packed*)(void*)array->valuestring,*fit;
+	if (p->count<cJSON_INDEX_THRESHOLD) return 0;
+	if (p->count<p->capacity && (fit=packed_resize(p,p->count))) array->valuestring=(char*)fit;
+	return 1;
+}
+
 /* Build an array from input text. */
 static const char *parse_array(cJSON *item,const char *value)
 {
@@ -318,10 +894,21 @@ static const char *parse_array(cJSON *item,const char *value)
 	value=skip(value+1);
 	if (*value==']') return value+1;	/* empty array. */
 
-	item->child=child=cJSON_New_Item();
-	if (!item->child) return 0;		 /* memory fail */
-	value=skip(parse_value(child,skip(value)));	/* skip any spacing, get the value. */
-	if (!value) return 0;
+	if (parse_pack && (*value=='-' || (*value>='0' && *value<='9')))
+	{
+		/* A leading run of numbers is packed. It stays packed if it is long and nothing else follows. */
+		if (!(value=parse_numbers(item,value))) return 0;
+		if (*value==']' && pack_fit(item)) return value+1;
+		if (!unpack(item)) return 0;
+		for (child=item->child;child->next;child=child->next);
+	}
+	else
+	{
+		item->child=child=cJSON_New_Item();
+		if (!item->child) return 0;		 /* memory fail */
+		value=skip(parse_value(child,skip(value)));	/* skip any spacing, get the value. */
+		if (!value) return 0;
+	}
 
 	while (*value==',')
 	{
@@ -341,11 +928,13 @@ static char *print_array(cJSON *item,int depth,int fmt)
 {
 	char **entries;
 	char *out=0,*ptr,*ret;int len=5;
+	struct cJSON_Packed *p=packed_of(item);cJSON n;
 	cJSON *child=item->child;
 	int numentries=0,i=0,fail=0;
 
 	/* How many entries in the array? */
-	while (child) numentries++,child=child->next;
+	if (p) numentries=p->count;
+	else while (child) numentries++,child=child->next;
 	/* Explicitly handle numentries==0 */
 	if (!numentries)
 	{
@@ -359,12 +948,12 @@ static char *print_array(cJSON *item,int depth,int fmt)
 	memset(entries,0,numentries*sizeof(char*));
 	/* Retrieve all the results: */
 	child=item->child;
-	while (child && !fail)
+	while (i<numentries && !fail)
 	{
-		ret=print_value(child,depth+1,fmt);
+		if (p) packed_get(p,i,&n),ret=print_number(&n);
+		else ret=print_value(child,depth+1,fmt),child=child->next;
 		entries[i++]=ret;
 		if (ret) len+=strlen(ret)+2+(fmt?1:0); else fail=1;
-		child=child->next;
 	}
 
 	/* If we didn't fail, try to malloc the output string */
@@ -394,10 +983,22 @@ static char *print_array(cJSON *item,int depth,int fmt)
 	return out;
 }
 
+/* Parse the value of member item, then give it the key parsed into holder before the type, and with it the place of a
+short key, was known. holder is left without a key. */
+static const char *parse_member(cJSON *item,cJSON *holder,const char *value)
+{
+	value=parse_value(item,value);
+	if (value && !(holder->type&cJSON_StringIsInline)) item->string=holder->string,item->type|=holder->type&cJSON_StringIsInterned,holder->string=0,holder->type=0;
+	else if (value && !(item->string=string_copy(item,holder->string,holder->keylen,1))) value=0;
+	item->keylen=item->string?holder->keylen:0;
+	key_free(holder);
+	return value;
+}
+
 /* Build an object from the text. */
 static const char *parse_object(cJSON *item,const char *value)
 {
-	cJSON *child;
+	cJSON *child,key;
 	if (*value!='{')	{ep=value;return 0;}	/* not an object! */
 
 	item->type=cJSON_Object;
@@ -406,11 +1007,11 @@ static const char *parse_object(cJSON *item,const char *value)
 
 	item->child=child=cJSON_New_Item();
 	if (!item->child) return 0;
-	value=skip(parse_string(child,skip(value)));
+	memset(&key,0,sizeof(key));
+	value=skip(parse_string(&key,skip(value),1));
 	if (!value) return 0;
-	child->string=child->valuestring;child->valuestring=0;
-	if (*value!=':') {ep=value;return 0;}	/* fail! */
-	value=skip(parse_value(child,skip(value+1)));	/* skip any spacing, get the value. */
+	if (*value!=':') {ep=value;key_free(&key);return 0;}	/* fail! */
+	value=skip(parse_member(child,&key,skip(value+1)));	/* skip any spacing, get the value. */
 	if (!value) return 0;
 
 	while (*value==',')
@@ -418,11 +1019,10 @@ static const char *parse_object(cJSON *item,const char *value)
 		cJSON *new_item;
 		if (!(new_item=cJSON_New_Item()))	return 0; /* memory fail */
 		child->next=new_item;new_item->prev=child;child=new_item;
-		value=skip(parse_string(child,skip(value+1)));
+		value=skip(parse_string(&key,skip(value+1),1));
 		if (!value) return 0;
-		child->string=child->valuestring;child->valuestring=0;
-		if (*value!=':') {ep=value;return 0;}	/* fail! */
-		value=skip(parse_value(child,skip(value+1)));	/* skip any spacing, get the value. */
+		if (*value!=':') {ep=value;key_free(&key);return 0;}	/* fail! */
+		value=skip(parse_member(child,&key,skip(value+1)));	/* skip any spacing, get the value. */
 		if (!value) return 0;
 	}
 
@@ -430,6 +1030,85 @@ static const char *parse_object(cJSON *item,const char *value)
 	ep=value;return 0;	/* malformed. */
 }
 
+/* Validate the input text the way the parser reads it, without allocating. Each returns the end of the value or 0. */
+static const char *validate_value(const char *value);
+static const char *validate_string(const char *str)
+{
+	if (*str!='\"') return 0;	/* not a string! */
+	str++;
+	while (*str && *str!='\"')
+	{
+		if ((unsigned char)*str<32) return 0;	/* control characters must be escaped. */
+		if (*str++!='\\') continue;
+		if (*str=='u') {int i;for (i=1;i<=4;i++) if (!isxdigit((unsigned char)str[i])) return 0;str+=5;}
+		else if (*str && strchr("\"\\/bfnrt",*str)) str++;
+		else return 0;
+	}
+	return (*str=='\"')?str+1:0;
+}
+static const char *validate_number(const char *num)
+{
+	if (*num=='-') num++;
+	if (*num=='0') num++;
+	else if (*num>='1' && *num<='9') while (*num>='0' && *num<='9') num++;
+	else return 0;
+	if (*num=='.') {num++;if (*num<'0' || *num>'9') return 0;while (*num>='0' && *num<='9') num++;}
+	if (*num=='e' || *num=='E')
+	{	num++;if (*num=='+' || *num=='-') num++;
+		if (*num<'0' || *num>'9') return 0;while (*num>='0' && *num<='9') num++;
+	}
+	return num;
+}
+static const char *validate_array(const char *value)
+{
+	value=skip(value+1);
+	if (*value==']') return value+1;	/* empty array. */
+	while (value)
+	{
+		value=skip(validate_value(skip(value)));
+		if (!value) return 0;
+		if (*value==']') return value+1;
+		if (*value!=',') return 0;
+		value++;
+	}
+	return 0;
+}
+static const char *validate_object(const char *value)
+{
+	value=skip(value+1);
+	if (*value=='}') return value+1;	/* empty object. */
+	while (value)
+	{
+		value=skip(validate_string(skip(value)));
+		if (!value || *value!=':') return 0;
+		value=skip(validate_value(skip(value+1)));
+		if (!value) return 0;
+		if (*value=='}') return value+1;
+		if (*value!=',') return 0;
+		value++;
+	}
+	return 0;
+}
+static const char *validate_value(const char *value)
+{
+	if (!value)						return 0;
+	if (!strncmp(value,"null",4))	return value+4;
+	if (!strncmp(value,"false",5))	return value+5;
+	if (!strncmp(value,"true",4))	return value+4;
+	if (*value=='\"')				return validate_string(value);
+	if (*value=='-' || (*value>='0' && *value<='9'))	return validate_number(value);
+	if (*value=='[')				return validate_array(value);
+	if (*value=='{')				return validate_object(value);
+	return 0;
+}
+int cJSON_Validate(const char *value)
+{
+	const char *end;
+	if (!value) return 0;
+	end=validate_value(skip(value));
+	return end && !*skip(end);
+}
+
 /* Render an object to text. */
 static char *print_object(cJSON *item,int depth,int fmt)
 {
@@ -461,7 +1140,7 @@ static char *print_object(cJSON *item,int depth,int fmt)
 	child=item->child;depth++;if (fmt) len+=depth;
 	while (child)
 	{
-		names[i]=str=print_string_ptr(child->string);
+		names[i]=str=print_string_ptr(child->string,key_length(child));
 		entries[i++]=ret=print_value(child,depth,fmt);
 		if (str && ret) len+=strlen(ret)+strlen(str)+2+(fmt?2+depth:0); else fail=1;
 		child=child->next;
@@ -499,32 +1178,176 @@ static char *print_object(cJSON *item,int depth,int fmt)
 }
 
 /* Get Array size/item / object item. */
-int    cJSON_GetArraySize(cJSON *array)							{cJSON *c=array->child;int i=0;while(c)i++,c=c->next;return i;}
-cJSON *cJSON_GetArrayItem(cJSON *array,int item)				{cJSON *c=array->child;  while (c && item>0) item--,c=c->next; return c;}
-cJSON *cJSON_GetObjectItem(cJSON *object,const char *string)	{cJSON *c=object->child; while (c && cJSON_strcasecmp(c->string,string)) c=c->next; return c;}
+int cJSON_GetArraySize(cJSON *array)
+{
+	cJSON *c;int i=0;struct cJSON_Index *index=index_of(array);struct cJSON_Packed *p=packed_of(array);
+	if (p) return p->count;
+	if (index) return index->count;
+	c=array->child;
+	if (c) for (i=1;c->next;c=c->next) i++;
+	if (i>=cJSON_INDEX_THRESHOLD) index_new(array,i,c);
+	return i;
+}
+
+/* Walk from the start or the cursor when the item is close to either, otherwise use the position table. */
+cJSON *cJSON_GetArrayItem(cJSON *array,int item)
+{
+	cJSON *c=cJSON_GetChild(array);struct cJSON_Index *index=index_of(array);int at=0;
+	if (!index && item>=cJSON_INDEX_THRESHOLD) {cJSON_GetArraySize(array);index=index_of(array);}
+	if (!index) {while (c && item>0) item--,c=c->next; return c;}
+	if (item<0) item=0;
+	if (item>=index->count) return 0;
+	if (cJSON_acquire(&index->valid)) return index->items[item];
+	index_lock(index);
+	if (index->valid) c=index->items[item],at=item;
+	else if (index->cursor && abs(item-index->at)<=cJSON_INDEX_THRESHOLD) c=index->cursor,at=index->at;
+	else if (item>cJSON_INDEX_THRESHOLD && items_build(array,index)) c=index->items[item],at=item;
+	while (at<item) at++,c=c->next;
+	while (at>item) at--,c=c->prev;
+	index->cursor=c;index->at=at;
+	index_unlock(index);
+	return c;
+}
+
+static int key_equal(const cJSON *c,const char *string,size_t len,int case_sensitive)
+{
+	if (c->string==string) return 1;	/* the same interned key */
+	if (!c->string || key_length(c)!=len) return 0;
+	return case_sensitive?!strcmp(c->string,string):!cJSON_strcasecmp(c->string,string);
+}
+
+/* Find a member by key, through the index if the object has one. A long walk builds the index. */
+static cJSON *find_item(cJSON *object,const char *string,int case_sensitive)
+{
+	size_t len,i,n=0;unsigned int hash;cJSON *c,**table;struct cJSON_Index *index;
+	if (!object || !string) return 0;
+	hash=cJSON_hash(string,&len);
+	index=index_of(object);
+	if (index && (table=cJSON_acquire(&index->table)))
+	{
+		for (i=hash&index->mask;(c=table[i]);i=(i+1)&index->mask)
+			if (key_equal(c,string,len,case_sensitive)) return c;
+		return 0;
+	}
+	for (c=object->child;c && !key_equal(c,string,len,case_sensitive);c=c->next) n++;
+	if (n>=cJSON_INDEX_THRESHOLD)
+	{
+		if (!index) {cJSON_GetArraySize(object);index=index_of(object);}
+		if (index) {index_lock(index);if (!index->table) keys_build(object,index);index_unlock(index);}
+	}
+	return c;
+}
+
+cJSON *cJSON_GetObjectItem(cJSON *object,const char *string)				{return find_item(object,string,0);}
+cJSON *cJSON_GetObjectItemCaseSensitive(cJSON *object,const char *string)	{return find_item(object,string,1);}
 
 /* Utility for array list handling. */
 static void suffix_object(cJSON *prev,cJSON *item) {prev->next=item;item->prev=prev;}
 /* Utility for handling references. */
-static cJSON *create_reference(cJSON *item) {cJSON *ref=cJSON_New_Item();if (!ref) return 0;memcpy(ref,item,sizeof(cJSON));ref->string=0;ref->type|=cJSON_IsReference;ref->next=ref->prev=0;return ref;}
+/* A reference to a packed array shares its nodes, made now, not its values. */
+static cJSON *create_reference(cJSON *item)
+{
+	cJSON *ref=cJSON_New_Item();size_t room;if (!ref) return 0;
+	if (item->type&cJSON_IsPacked) cJSON_GetChild(item);
+	memcpy(ref,item,sizeof(cJSON));ref->string=0;ref->keylen=0;ref->type=(item->type&~(cJSON_IsFrozen|cJSON_IsPacked|cJSON_StringIsInline|cJSON_StringIsInterned))|cJSON_IsReference;ref->next=ref->prev=0;
+	if (item->type&cJSON_StringIsInline) memset(key_storage(ref,&room),0,room);
+	if (index_of(ref)) ref->index=0;
+	if (item->type&cJSON_IsPacked) ref->valuestring=0;
+	if (item->type&cJSON_ValueIsInline) ref->valuestring=(char*)&ref->valueint;
+	return ref;
+}
+/* Unlink c, at position pos or -1 if not known, from parent. */
+static cJSON *detach_item(cJSON *parent,cJSON *c,int pos)
+{
+	if (parent->type&cJSON_IsFrozen) return 0;
+	unpack(parent);	/* c is one of its nodes, so they are made */
+	if (index_of(parent)) parent->index->changes++;
+	index_remove(parent,c,pos);
+	if (c->prev) c->prev->next=c->next;if (c->next) c->next->prev=c->prev;if (c==parent->child) parent->child=c->next;c->prev=c->next=0;return c;
+}
+/* Put newitem in the place of c, at position pos or -1 if not known, and delete c. */
+static void replace_item(cJSON *parent,cJSON *c,cJSON *newitem,int pos)
+{
+	unpack(parent);
+	if (index_of(parent)) parent->index->changes++;
+	index_replace(parent,c,newitem,pos);
+	newitem->next=c->next;newitem->prev=c->prev;if (newitem->next) newitem->next->prev=newitem;
+	if (c==parent->child) parent->child=newitem; else newitem->prev->next=newitem;c->next=c->prev=0;cJSON_Delete(c);
+}
+/* Name newitem string, it is about to join an object. */
+/* Name an item before it is linked, so a key that cannot be copied leaves the item with its caller. */
+static int set_key(cJSON *newitem,const char *string) {return cJSON_SetItemKey(newitem,string);}
+int cJSON_SetItemKey(cJSON *item,const char *string)
+{
+	size_t len=string?strlen(string):0;
+	key_free(item);
+	if (string && len>=cJSON_INLINE_STRING && thread_keys) return key_intern(item,thread_keys,string);
+	item->string=string?string_copy(item,string,len,1):0;cJSON_SetKey(item);
+	return !string || item->string;
+}
+
+/* Recompute the keys and prev links below item and drop the indexes, rebuilt when next needed. */
+void cJSON_Rekey(cJSON *item)
+{
+	cJSON *c,*prev=0;
+	if (!item || (item->type&cJSON_IsFrozen)) return;
+	cJSON_SetKey(item);
+	if (packed_of(item)) return;
+	if (!(item->type&cJSON_IsReference)) index_free(item);
+	for (c=item->child;c;prev=c,c=c->next) c->prev=prev,cJSON_Rekey(c);
+}
 
 /* Add item to array/object. */
-void   cJSON_AddItemToArray(cJSON *array, cJSON *item)						{cJSON *c=array->child;if (!item) return; if (!c) {array->child=item;} else {while (c && c->next) c=c->next; suffix_object(c,item);}}
-void   cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item)	{if (!item) return; if (item->string) cJSON_free(item->string);item->string=cJSON_strdup(string);cJSON_AddItemToArray(object,item);}
-void	cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)						{cJSON_AddItemToArray(array,create_reference(item));}
-void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item)	{cJSON_AddItemToObject(object,string,create_reference(item));}
+/* Append through the tail pointer of an indexed array. A long walk to the end indexes the array. */
+void   cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+	cJSON *c;int n=1;
+	if (!item || (array->type&cJSON_IsFrozen) || !unpack(array)) return;
+	if (index_of(array)) array->index->changes++;
+	c=array->child;
+	if (index_of(array)) c=array->index->tail;
+	else if (c) {while (c->next) c=c->next,n++; if (n>=cJSON_INDEX_THRESHOLD) index_new(array,n,c);}
+	if (!c) array->child=item; else suffix_object(c,item);
+	index_add(array,item);
+}
 
-cJSON *cJSON_DetachItemFromArray(cJSON *array,int which)			{cJSON *c=array->child;while (c && which>0) c=c->next,which--;if (!c) return 0;
-	if (c->prev) c->prev->next=c->next;if (c->next) c->next->prev=c->prev;if (c==array->child) array->child=c->next;c->prev=c->next=0;return c;}
+/* Append to the values of a packed array while they can hold num. */
+int cJSON_AddNumberToArray(cJSON *array,double num)
+{
+	struct cJSON_Packed *p,*grown;cJSON *item;
+	if (!array || (array->type&cJSON_IsFrozen)) return 0;
+	if ((p=packed_of(array)) && (!p->integers || (num>=-9223372036854775808.0 && num<9223372036854775808.0 && num==(double)(int64_t)num)))
+	{
+		if (p->count==p->capacity)
+		{
+			if (!(grown=packed_resize(p,p->capacity*2))) return 0;
+			array->valuestring=(char*)(p=grown);
+		}
+		if (p->integers) p->values[p->count++].i=(int64_t)num; else p->values[p->count++].d=num;
+		return 1;
+	}
+	if (!unpack(array) || !(item=cJSON_CreateNumber(num))) return 0;
+	cJSON_AddItemToArray(array,item);
+	return 1;
+}
+
+void   cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item)	{if (!item || (object->type&cJSON_IsFrozen)) return; if (set_key(item,string)) cJSON_AddItemToArray(object,item);}
+void	cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item)						{if (!(array->type&cJSON_IsFrozen)) cJSON_AddItemToArray(array,create_reference(item));}
+void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item)	{if (!(object->type&cJSON_IsFrozen)) cJSON_AddItemToObject(object,string,create_reference(item));}
+
+cJSON *cJSON_DetachItemFromArray(cJSON *array,int which)			{cJSON *c;if (which<0) which=0;c=cJSON_GetArrayItem(array,which);if (!c) return 0;return detach_item(array,c,which);}
 void   cJSON_DeleteItemFromArray(cJSON *array,int which)			{cJSON_Delete(cJSON_DetachItemFromArray(array,which));}
-cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string) {int i=0;cJSON *c=object->child;while (c && cJSON_strcasecmp(c->string,string)) i++,c=c->next;if (c) return cJSON_DetachItemFromArray(object,i);return 0;}
+cJSON *cJSON_DetachItemFromObject(cJSON *object,const char *string) {cJSON *c=find_item(object,string,0);if (c) return detach_item(object,c,-1);return 0;}
 void   cJSON_DeleteItemFromObject(cJSON *object,const char *string) {cJSON_Delete(cJSON_DetachItemFromObject(object,string));}
+cJSON *cJSON_DetachItemFromObjectCaseSensitive(cJSON *object,const char *string) {cJSON *c=find_item(object,string,1);if (c) return detach_item(object,c,-1);return 0;}
+void   cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object,const char *string) {cJSON_Delete(cJSON_DetachItemFromObjectCaseSensitive(object,string));}
 
 /* Replace array/object items with new ones. */
-void   cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem)		{cJSON *c=array->child;while (c && which>0) c=c->next,which--;if (!c) return;
-	newitem->next=c->next;newitem->prev=c->prev;if (newitem->next) newitem->next->prev=newitem;
-	if (c==array->child) array->child=newitem; else newitem->prev->next=newitem;c->next=c->prev=0;cJSON_Delete(c);}
-void   cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem){int i=0;cJSON *c=object->child;while(c && cJSON_strcasecmp(c->string,string))i++,c=c->next;if(c){newitem->string=cJSON_strdup(string);cJSON_ReplaceItemInArray(object,i,newitem);}}
+void   cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem)		{cJSON *c;if (array->type&cJSON_IsFrozen) return;if (which<0) which=0;c=cJSON_GetArrayItem(array,which);if (!c) return;replace_item(array,c,newitem,which);}
+void   cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem){cJSON *c=(object->type&cJSON_IsFrozen)?0:find_item(object,string,0);if(c && set_key(newitem,string)) replace_item(object,c,newitem,-1);}
+void   cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem){cJSON *c=(object->type&cJSON_IsFrozen)?0:find_item(object,string,1);if(c && set_key(newitem,string)) replace_item(object,c,newitem,-1);}
+void   cJSON_SetItemInObject(cJSON *object,const char *string,cJSON *newitem){cJSON *c;if (!newitem || (object->type&cJSON_IsFrozen)) return;c=find_item(object,string,0);if(c){if (set_key(newitem,string)) replace_item(object,c,newitem,-1);}else cJSON_AddItemToObject(object,string,newitem);}
+void   cJSON_SetItemInObjectCaseSensitive(cJSON *object,const char *string,cJSON *newitem){cJSON *c;if (!newitem || (object->type&cJSON_IsFrozen)) return;c=find_item(object,string,1);if(c){if (set_key(newitem,string)) replace_item(object,c,newitem,-1);}else cJSON_AddItemToObject(object,string,newitem);}
 
 /* Create basic types: */
 cJSON *cJSON_CreateNull(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_NULL;return item;}
@@ -532,30 +1355,42 @@ cJSON *cJSON_CreateTrue(void)					{cJSON *item=cJSON_New_Item();if(item)item->ty
 cJSON *cJSON_CreateFalse(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_False;return item;}
 cJSON *cJSON_CreateBool(int b)					{cJSON *item=cJSON_New_Item();if(item)item->type=b?cJSON_True:cJSON_False;return item;}
 cJSON *cJSON_CreateNumber(double num)			{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_Number;item->valuedouble=num;item->valueint=(int64_t)num;}return item;}
-cJSON *cJSON_CreateString(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=cJSON_strdup(string);}return item;}
+cJSON *cJSON_CreateString(const char *string)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=string_copy(item,string,strlen(string),0);}return item;}
+cJSON *cJSON_CreateStringWithLength(const char *string,size_t length)	{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_String;item->valuestring=string_copy(item,string,length,0);}return item;}
 cJSON *cJSON_CreateArray(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Array;return item;}
 cJSON *cJSON_CreateObject(void)					{cJSON *item=cJSON_New_Item();if(item)item->type=cJSON_Object;return item;}
+cJSON *cJSON_CreateRaw(const char *raw)			{cJSON *item=cJSON_New_Item();if(item){item->type=cJSON_Raw;item->valuestring=string_copy(item,raw,strlen(raw),0);if(!item->valuestring){cJSON_free(item);return 0;}}return item;}
 
 /* Create Arrays: */
 cJSON *cJSON_CreateIntArray(int *numbers,int count)				{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
 cJSON *cJSON_CreateInt64Array(int64_t *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
 cJSON *cJSON_CreateFloatArray(float *numbers,int count)			{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
 cJSON *cJSON_CreateDoubleArray(double *numbers,int count)		{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateNumber(numbers[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
+/* Arrays of at least cJSON_INDEX_THRESHOLD numbers are packed, shorter ones are made as above. */
+cJSON *cJSON_CreatePackedIntArray(int *numbers,int count)		{int i;cJSON *a;if (count<cJSON_INDEX_THRESHOLD) return cJSON_CreateIntArray(numbers,count);if ((a=packed_array(count,1))) for(i=0;i<count;i++) ((struct cJSON_Packed*)(void*)a->valuestring)->values[i].i=numbers[i];return a;}
+cJSON *cJSON_CreatePackedInt64Array(int64_t *numbers,int count)	{int i;cJSON *a;if (count<cJSON_INDEX_THRESHOLD) return cJSON_CreateInt64Array(numbers,count);if ((a=packed_array(count,1))) for(i=0;i<count;i++) ((struct cJSON_Packed*)(void*)a->valuestring)->values[i].i=numbers[i];return a;}
+cJSON *cJSON_CreatePackedFloatArray(float *numbers,int count)	{int i;cJSON *a;if (count<cJSON_INDEX_THRESHOLD) return cJSON_CreateFloatArray(numbers,count);if ((a=packed_array(count,0))) for(i=0;i<count;i++) ((struct cJSON_Packed*)(void*)a->valuestring)->values[i].d=numbers[i];return a;}
+cJSON *cJSON_CreatePackedDoubleArray(double *numbers,int count)	{int i;cJSON *a;if (count<cJSON_INDEX_THRESHOLD) return cJSON_CreateDoubleArray(numbers,count);if ((a=packed_array(count,0))) for(i=0;i<count;i++) ((struct cJSON_Packed*)(void*)a->valuestring)->values[i].d=numbers[i];return a;}
 cJSON *cJSON_CreateStringArray(const char **strings,int count)	{int i;cJSON *n=0,*p=0,*a=cJSON_CreateArray();for(i=0;a && i<count;i++){n=cJSON_CreateString(strings[i]);if(!i)a->child=n;else suffix_object(p,n);p=n;}return a;}
 
 /* Duplication */
 cJSON *cJSON_Duplicate(cJSON *item,int recurse)
 {
-	cJSON *newitem,*cptr,*nptr=0,*newchild;
+	cJSON *newitem,*cptr,*nptr=0,*newchild;struct cJSON_Packed *p;
 	/* Bail on bad ptr */
 	if (!item) return 0;
 	/* Create new item */
 	newitem=cJSON_New_Item();
 	if (!newitem) return 0;
 	/* Copy over all vars */
-	newitem->type=item->type&(~cJSON_IsReference),newitem->valueint=item->valueint,newitem->valuedouble=item->valuedouble;
-	if (item->valuestring)	{newitem->valuestring=cJSON_strdup(item->valuestring);	if (!newitem->valuestring)	{cJSON_Delete(newitem);return 0;}}
-	if (item->string)		{newitem->string=cJSON_strdup(item->string);			if (!newitem->string)		{cJSON_Delete(newitem);return 0;}}
+	newitem->type=item->type&(~(cJSON_IsReference|cJSON_IsFrozen|cJSON_IsPacked|cJSON_StringIsInline|cJSON_ValueIsInline|cJSON_StringIsInterned));
+	if (!is_container(item))	newitem->valueint=item->valueint;	/* the fields that may hold a key or an index are left 0 */
+	if ((item->type&255)==cJSON_Number)	newitem->valuedouble=item->valuedouble;
+	if (recurse && (p=packed_of(item)))	{newitem->valuestring=(char*)packed_copy(p,p->count);	if (!newitem->valuestring)	{cJSON_Delete(newitem);return 0;}	newitem->type|=cJSON_IsPacked;}
+	else if (value_text(item))	{newitem->valuestring=string_copy(newitem,item->valuestring,string_length(item),0);	if (!newitem->valuestring)	{cJSON_Delete(newitem);return 0;}}
+	if (item->type&cJSON_StringIsInterned)	{cJSON_increment(&key_of(item->string)->refs);newitem->string=item->string;newitem->type|=cJSON_StringIsInterned;}	/* shared */
+	else if (item->string)	{newitem->string=string_copy(newitem,item->string,key_length(item),1);	if (!newitem->string)		{cJSON_Delete(newitem);return 0;}}
+	newitem->keylen=item->keylen;
 	/* If non-recursive, then we're done! */
 	if (!recurse) return newitem;
 	/* Walk the ->next chain for the child. */
@@ -570,3 +1405,784 @@ cJSON *cJSON_Duplicate(cJSON *item,int recurse)
 	}
 	return newitem;
 }
+
+/* Children lists and strings by address, probed linearly, with a value for each when to is set. */
+struct pointers {const void **from;void **to;size_t mask,used;};
+
+/* Start with room for 8. Returns 0 without memory. */
+static int pointers_init(struct pointers *set)
+{
+	set->to=0;set->mask=15;set->used=0;
+	if (!(set->from=(const void**)cJSON_malloc(16*sizeof(void*)))) return 0;
+	memset(set->from,0,16*sizeof(void*));
+	return 1;
+}
+
+static size_t pointers_slot(const struct pointers *set,const void *from)
+{
+	size_t i=(size_t)(((uintptr_t)from>>4)*0x9e3779b97f4a7c15ULL)&set->mask;
+	while (set->from[i] && set->from[i]!=from) i=(i+1)&set->mask;
+	return i;
+}
+
+/* Add from, growing the table, which must have no values yet. Returns 0 without memory. */
+static int pointers_add(struct pointers *set,const void *from)
+{
+	size_t i,mask=2*set->mask+1;const void **old=set->from;
+	if (2*(set->used+1)>set->mask+1)
+	{
+		if (!(set->from=(const void**)cJSON_malloc((mask+1)*sizeof(void*)))) {set->from=old;return 0;}
+		memset(set->from,0,(mask+1)*sizeof(void*));
+		for (i=0,set->mask=mask;i<=mask/2;i++) if (old[i]) set->from[pointers_slot(set,old[i])]=old[i];
+		cJSON_free(old);
+	}
+	i=pointers_slot(set,from);
+	if (!set->from[i]) set->from[i]=from,set->used++;
+	return 1;
+}
+
+/* The children or text item would share as a reference, or 0. */
+static const void *shared_target(cJSON *item)
+{
+	if (item->type&cJSON_IsPacked) return 0;
+	if (item->child) return item->child;
+	return !(item->type&cJSON_ValueIsInline)?value_text(item):0;
+}
+
+static int has_references(cJSON *item)
+{
+	cJSON *c;
+	if (item->type&cJSON_IsReference) return 1;
+	for (c=item->child;c;c=c->next) if (has_references(c)) return 1;
+	return 0;
+}
+
+/* Children and text already copied: a reference met after them shares the copy. Measuring adds every address,
+filling records the copies; both walk in the same order, so they agree on what is shared. */
+struct freeze_size {size_t nodes,indexes,slots,bytes;struct pointers *shared;};
+struct freeze_state {cJSON *node;struct cJSON_Index *index;cJSON **slot;char *text;struct pointers *shared;};
+
+/* Count what the frozen copy of item needs. The root keeps no key. Returns 0 without memory. */
+static int freeze_measure(cJSON *item,int root,struct freeze_size *size)
+{
+	cJSON *c;int count=0;struct cJSON_Packed *p=packed_of(item);const void *target=size->shared?shared_target(item):0;
+	size->nodes++;
+	if (!root && item->string) size->bytes+=key_length(item)+1;
+	if (target)
+	{
+		if ((item->type&cJSON_IsReference) && size->shared->from[pointers_slot(size->shared,target)]) return 1;
+		if (!pointers_add(size->shared,target)) return 0;
+	}
+	if (p) size->bytes+=packed_size(p->count)+7;	/* aligned among the strings */
+	else if (value_text(item)) size->bytes+=string_length(item)+1;
+	for (c=item->child;c;c=c->next) if (count++,!freeze_measure(c,0,size)) return 0;
+	if (count<cJSON_INDEX_THRESHOLD) return 1;
+	size->indexes++;size->slots+=count;
+	if ((item->type&255)==cJSON_Object) size->slots+=keys_size(count);
+	return 1;
+}
+
+static char *freeze_text(const char *str,size_t len,struct freeze_state *state)
+{
+	char *copy=state->text;
+	memcpy(copy,str,len);copy[len]=0;state->text+=len+1;
+	return copy;
+}
+
+/* Copy item and its children depth first into the block, indexing large containers as it goes. */
+static cJSON *freeze_fill(cJSON *item,int root,struct freeze_state *state)
+{
+	cJSON *node=state->node++,*c,*child,*prev=0;struct cJSON_Index *index;int count=0;size_t size,slot=0;
+	struct cJSON_Packed *p=packed_of(item),*copy;const void *target=state->shared?shared_target(item):0;
+	node->type=(item->type&255)|cJSON_IsFrozen;
+	if (!is_container(item)) node->valueint=item->valueint;
+	if ((item->type&255)==cJSON_Number) node->valuedouble=item->valuedouble;
+	if (!root && item->string) {size=key_length(item);node->keylen=(unsigned int)size;node->string=freeze_text(item->string,size,state);}
+	if (target)
+	{
+		slot=pointers_slot(state->shared,target);
+		if ((item->type&cJSON_IsReference) && state->shared->to[slot])
+		{
+			node->type|=cJSON_IsReference;
+			if (item->child) node->child=(cJSON*)state->shared->to[slot]; else node->valuestring=(char*)state->shared->to[slot];
+			return node;
+		}
+		state->shared->to[slot]=item->child?(void*)state->node:(void*)state->text;	/* where the first child or the text goes next */
+	}
+	if (p)
+	{
+		copy=(struct cJSON_Packed*)(((uintptr_t)state->text+7)&~(uintptr_t)7);
+		memcpy(copy,p,packed_size(p->count));copy->capacity=p->count;
+		state->text=(char*)copy+packed_size(p->count);
+		node->valuestring=(char*)copy;node->type|=cJSON_IsPacked;
+		return node;
+	}
+	if (value_text(item)) node->valuestring=freeze_text(item->valuestring,node->valueint=(int64_t)string_length(item),state);
+	for (c=item->child;c;c=c->next,count++)
+	{
+		child=freeze_fill(c,0,state);
+		if (prev) suffix_object(prev,child); else node->child=child;
+		prev=child;
+	}
+	if (count<cJSON_INDEX_THRESHOLD) return node;
+	node->index=index=state->index++;
+	index->count=count;index->tail=prev;index->frozen=1;
+	index->items=state->slot;index->capacity=count;index->valid=1;state->slot+=count;
+	for (count=0,c=node->child;c;c=c->next) index->items[count++]=c;
+	if ((node->type&255)!=cJSON_Object) return node;
+	size=keys_size(count);
+	index->table=state->slot;index->mask=size-1;state->slot+=size;
+	for (c=node->child;c;c=c->next) if (c->string) keys_insert(index->table,index->mask,c),index->used++;
+	return node;
+}
+
+/* Measure the block for item, sharing what its references share. Returns the bytes it takes, or 0 without memory;
+shared.from is left for the caller to free. */
+static size_t block_measure(cJSON *item,struct freeze_size *size,struct pointers *shared)
+{
+	if (has_references(item))
+	{
+		if (!pointers_init(shared)) return 0;
+		size->shared=shared;
+	}
+	if (!freeze_measure(item,1,size)) return 0;
+	return sizeof(struct cJSON_Block)+size->nodes*sizeof(cJSON)+size->indexes*sizeof(struct cJSON_Index)+size->slots*sizeof(cJSON*)+size->bytes;
+}
+
+/* Allocate a block for item and fill it. A tree holding references shares what they share. */
+static struct cJSON_Block *block_build(cJSON *item)
+{
+	struct freeze_size size={0,0,0,0,0};struct freeze_state state;struct cJSON_Block *block=0;struct pointers shared={0,0,0,0};size_t total,fixed;
+	if (!(total=block_measure(item,&size,&shared))) goto done;
+	if (size.shared && !(shared.to=(void**)cJSON_malloc((shared.mask+1)*sizeof(void*)))) goto done;
+	if (shared.to) memset(shared.to,0,(shared.mask+1)*sizeof(void*));
+	fixed=total-size.bytes;
+	if (!(block=(struct cJSON_Block*)cJSON_malloc(total))) goto done;
+	memset(block,0,fixed);
+	block->size=total;block->nodes=size.nodes;block->indexes=size.indexes;block->slots=size.slots;
+	state.node=(cJSON*)(block+1);state.index=(struct cJSON_Index*)(state.node+size.nodes);
+	state.slot=(cJSON**)(state.index+size.indexes);state.text=(char*)(state.slot+size.slots);state.shared=size.shared;
+	freeze_fill(item,1,&state);
+done:
+	cJSON_free(shared.from);cJSON_free(shared.to);
+	return block;
+}
+
+cJSON *cJSON_Freeze(cJSON *item)
+{
+	struct cJSON_Block *block;
+	if (!item || !(block=block_build(item))) return 0;
+	return (cJSON*)(block+1);
+}
+
+/* Move every pointer in the block by delta bytes. */
+#define relocate(p,delta) if (p) (p)=(void*)((uintptr_t)(p)+(delta))
+static void block_relocate(struct cJSON_Block *block,uintptr_t delta)
+{
+	cJSON *node=(cJSON*)(block+1);struct cJSON_Index *index=(struct cJSON_Index*)(node+block->nodes);
+	cJSON **slot=(cJSON**)(index+block->indexes);uint64_t i;
+	for (i=0;i<block->nodes;i++,node++)
+	{
+		relocate(node->next,delta);relocate(node->prev,delta);relocate(node->child,delta);
+		relocate(node->valuestring,delta);relocate(node->string,delta);
+		if (is_container(node)) relocate(node->index,delta);
+	}
+	for (i=0;i<block->indexes;i++,index++) {relocate(index->tail,delta);relocate(index->items,delta);relocate(index->table,delta);}
+	for (i=0;i<block->slots;i++,slot++) relocate(*slot,delta);
+}
+
+void *cJSON_Snapshot(cJSON *item,size_t *size)
+{
+	struct cJSON_Block *block;
+	if (!item || !(block=block_build(item))) return 0;
+	block_relocate(block,0-(uintptr_t)block);
+	memcpy(block->magic,cJSON_SNAPSHOT,sizeof(block->magic));
+	block->version=cJSON_SNAPSHOT_VERSION;block->layout=cJSON_SNAPSHOT_LAYOUT;
+	if (size) *size=(size_t)block->size;
+	return block;
+}
+
+/* The bytes of the header, nodes, indexes and tables of the snapshot in image, 0 if it is not one this build can
+read. Each count is bounded by the size before it is multiplied, so none of the products can wrap. */
+static size_t snapshot_fixed(const void *image,size_t size)
+{
+	const struct cJSON_Block *block=(const struct cJSON_Block*)image;
+	if (!image || ((uintptr_t)image&7) || size<sizeof(struct cJSON_Block)) return 0;
+	if (memcmp(block->magic,cJSON_SNAPSHOT,sizeof(block->magic)) || block->version!=cJSON_SNAPSHOT_VERSION || block->layout!=cJSON_SNAPSHOT_LAYOUT) return 0;
+	if (block->size!=size || !block->nodes || block->nodes>size/sizeof(cJSON) || block->indexes>size/sizeof(struct cJSON_Index) || block->slots>size/sizeof(cJSON*)) return 0;
+	size=sizeof(struct cJSON_Block)+(size_t)block->nodes*sizeof(cJSON)+(size_t)block->indexes*sizeof(struct cJSON_Index)+(size_t)block->slots*sizeof(cJSON*);
+	return size<=(size_t)block->size?size:0;
+}
+
+size_t cJSON_SnapshotWritable(const void *image,size_t size)	{return snapshot_fixed(image,size);}
+
+/* Whether p is 0 or one of the units of bytes from from to to. */
+static int block_holds(const void *p,const void *from,const void *to,size_t unit)
+{
+	uintptr_t at=(uintptr_t)p;
+	return !p || (at>=(uintptr_t)from && at<(uintptr_t)to && (at-(uintptr_t)from)%unit==0);
+}
+
+/* Whether str is 0 or len bytes and a NUL from text to end. */
+static int block_holds_text(const char *str,int64_t len,const char *text,const char *end)
+{
+	return !str || ((uintptr_t)str>=(uintptr_t)text && (uintptr_t)str<(uintptr_t)end && len>=0 && (uint64_t)len<(uint64_t)(end-str) && !str[len]);
+}
+
+/* Whether every pointer in a loaded snapshot lands in its part of the block: links on nodes, each after the node
+it leaves except a reference to a copy made before it, node indexes on indexes, tables on slots and strings and
+packed numbers on the text. Anything else in the image is data. */
+static int block_check(const struct cJSON_Block *block)
+{
+	const cJSON *nodes=(const cJSON*)(block+1),*nodes_end=nodes+block->nodes,*node;
+	const struct cJSON_Index *indexes=(const struct cJSON_Index*)nodes_end,*indexes_end=indexes+block->indexes,*index;
+	cJSON *const *slots=(cJSON *const*)indexes_end,*const *slots_end=slots+block->slots,*const *slot;
+	const char *text=(const char*)slots_end,*end=(const char*)block+block->size;const struct cJSON_Packed *p;size_t i;
+	for (node=nodes;node<nodes_end;node++)
+	{
+		if ((node->type&~(255|cJSON_IsReference|cJSON_IsPacked))!=cJSON_IsFrozen) return 0;
+		if (!block_holds(node->next,nodes,nodes_end,sizeof(cJSON)) || (node->next && node->next<=node)) return 0;
+		if (!block_holds(node->prev,nodes,nodes_end,sizeof(cJSON)) || (node->prev && node->prev>=node)) return 0;
+		if (!block_holds(node->child,nodes,nodes_end,sizeof(cJSON)) || (node->child && (node->type&cJSON_IsReference?node->child>=node:node->child<=node))) return 0;
+		if (is_container(node) && !block_holds(node->index,indexes,indexes_end,sizeof(struct cJSON_Index))) return 0;
+		if (!block_holds_text(node->string,(int64_t)node->keylen,text,end)) return 0;
+		if (!(node->type&cJSON_IsPacked)) {if (!block_holds_text(node->valuestring,node->valueint,text,end)) return 0;continue;}
+		p=(const struct cJSON_Packed*)(const void*)node->valuestring;
+		if (node->child || !p || !block_holds(p,text,end,8) || p->count<0 || p->count>p->capacity || packed_size(p->capacity)>(size_t)(end-(const char*)p)) return 0;
+	}
+	for (index=indexes;index<indexes_end;index++)
+	{
+		if (!index->frozen || !index->valid || index->lock || index->cursor || index->count<0 || index->capacity<index->count) return 0;
+		if (!block_holds(index->tail,nodes,nodes_end,sizeof(cJSON)) || !index->items || !block_holds(index->items,slots,slots_end,sizeof(cJSON*))) return 0;
+		if ((size_t)index->capacity>(size_t)(slots_end-index->items)) return 0;
+		if (!index->table) continue;
+		if (!block_holds(index->table,slots,slots_end,sizeof(cJSON*)) || (index->mask&(index->mask+1)) || index->mask>=(size_t)(slots_end-index->table)) return 0;
+		for (i=0;i<=index->mask && index->table[i];i++);
+		if (i>index->mask) return 0;	/* a lookup stops at an empty slot */
+	}
+	for (slot=slots;slot<slots_end;slot++) if (!block_holds(*slot,nodes,nodes_end,sizeof(cJSON))) return 0;
+	return 1;
+}
+
+/* Turning the offsets into pointers and checking them reads every node, index and table, and the end of every string,
+so a load takes time in proportion to the tree; nothing of the text is written. */
+cJSON *cJSON_LoadSnapshot(void *image,size_t size,void (*release)(void *image,size_t size))
+{
+	struct cJSON_Block *block=(struct cJSON_Block*)image;
+	if (!snapshot_fixed(image,size)) return 0;
+	block_relocate(block,(uintptr_t)block);
+	if (!block_check(block)) return 0;
+	block->release=release;
+	return (cJSON*)(block+1);
+}
+
+static uint64_t hash_mix(uint64_t h,uint64_t v)	{h=(h^v)*0xff51afd7ed558ccdULL;return h^(h>>32);}
+
+static uint64_t hash_string(const char *str,size_t len,uint64_t h)
+{
+	size_t i;uint64_t w;
+	for (i=0;i+8<=len;i+=8) {memcpy(&w,str+i,8);h=hash_mix(h,w);}
+	w=0;memcpy(&w,str+i,len-i);
+	return hash_mix(h,w^((uint64_t)len<<56));
+}
+
+/* Hash item, adding the number of nodes hashed to *nodes. Arrays and objects of many nodes keep their hash in their
+index when nothing can change it unseen: when they are frozen, or when none of their children is an array or object,
+whose own children change without their parent knowing. Those children keep their own hashes. */
+static uint64_t hash_item(cJSON *item,uint64_t seed,int ordered,int *nodes)
+{
+	uint64_t h=hash_mix(seed,(uint64_t)(item->type&255)+1),sum=0,v;double d;
+	struct cJSON_Index *index;cJSON *c,*tail=0,number;int n=0,count=0,cached,deep=0;struct cJSON_Packed *p;
+	(*nodes)++;
+	switch (item->type&255)
+	{
+		case cJSON_Number:	d=item->valuedouble;if (d==0) d=0;	/* -0 compares equal to 0 */
+							memcpy(&v,&d,sizeof(v));return hash_mix(h,v);
+		case cJSON_String:
+		case cJSON_Raw:		return item->valuestring?hash_string(item->valuestring,string_length(item),h):h;
+		case cJSON_Array:
+		case cJSON_Object:	break;
+		default:			return h;
+	}
+	if ((p=packed_of(item)))
+	{
+		/* the values hash as their nodes would, without a cache */
+		for (;count<p->count;count++) packed_get(p,count,&number),h=hash_mix(h,hash_item(&number,seed,ordered,nodes));
+		return hash_mix(h,(uint64_t)count);
+	}
+	if ((index=index_of(item)))
+	{
+		index_lock(index);
+		cached=index->hashgen==index->changes+1 && index->hashseed==seed && index->hashordered==ordered;
+		if (cached) h=index->hash;
+		index_unlock(index);
+		if (cached) {*nodes+=cJSON_INDEX_THRESHOLD;return h;}
+	}
+	/* Members are hashed with their keys. Unless ordered their hashes are summed, so any order gives the same hash. */
+	for (c=item->child;c;tail=c,c=c->next,count++)
+	{
+		v=hash_item(c,seed,ordered,&n);deep|=(c->type&255)==cJSON_Array || (c->type&255)==cJSON_Object;
+		if ((item->type&255)==cJSON_Object) v=hash_mix(c->string?hash_string(c->string,key_length(c),seed):seed,v);
+		if (ordered || (item->type&255)==cJSON_Array) h=hash_mix(h,v); else sum+=v;
+	}
+	h=hash_mix(h,sum^(uint64_t)count);
+	*nodes+=n;
+	if (deep && !(item->type&cJSON_IsFrozen)) return h;
+	if (!index && n>=cJSON_INDEX_THRESHOLD) index=index_new(item,count,tail);
+	if (index)
+	{
+		index_lock(index);
+		index->hash=h;index->hashseed=seed;index->hashordered=ordered;index->hashgen=index->changes+1;
+		index_unlock(index);
+	}
+	return h;
+}
+
+uint64_t cJSON_Hash(cJSON *item,uint64_t seed,int ordered)	{int nodes=0;return item?hash_item(item,seed,ordered?1:0,&nodes):seed;}
+
+/* Number of members of object under the exact key of item that hold what it holds. */
+static int count_equal(cJSON *object,cJSON *item,int ordered)
+{
+	size_t len,i;unsigned int hash=cJSON_hash(item->string,&len);int n=0;cJSON *c,**table;struct cJSON_Index *index;
+	find_item(object,item->string,1);	/* a long object gets its key table */
+	if ((index=index_of(object)) && (table=cJSON_acquire(&index->table)))
+	{
+		for (i=hash&index->mask;(c=table[i]);i=(i+1)&index->mask) if (key_equal(c,item->string,len,1) && cJSON_Compare(c,item,ordered)) n++;
+		return n;
+	}
+	for (c=object->child;c;c=c->next) if (key_equal(c,item->string,len,1) && cJSON_Compare(c,item,ordered)) n++;
+	return n;
+}
+
+/* Compare two trees, stopping at the first difference. */
+int cJSON_Compare(cJSON *a,cJSON *b,int ordered)
+{
+	cJSON *ca,*cb,na,nb;struct cJSON_Packed *pa,*pb;int i,n;
+	if (a==b) return 1;
+	if (!a || !b || (a->type&255)!=(b->type&255)) return 0;
+	switch (a->type&255)
+	{
+		case cJSON_Number:	return a->valuedouble==b->valuedouble;
+		case cJSON_String:
+		case cJSON_Raw:		return a->valuestring && b->valuestring && string_length(a)==string_length(b) && !memcmp(a->valuestring,b->valuestring,string_length(a));
+		case cJSON_Array:
+			pa=packed_of(a);pb=packed_of(b);
+			if (pa || pb)
+			{
+				/* values against values, or against the nodes of the other array */
+				if (!pa) pa=pb,pb=0,b=a;
+				for (i=0,cb=pb?0:b->child;i<pa->count;i++)
+				{
+					packed_get(pa,i,&na);
+					if (pb) {if (i>=pb->count) return 0;packed_get(pb,i,&nb);cb=&nb;}
+					if (!cb || (cb->type&255)!=cJSON_Number || cb->valuedouble!=na.valuedouble) return 0;
+					if (!pb) cb=cb->next;
+				}
+				return pb?pb->count==pa->count:!cb;
+			}
+			for (ca=a->child,cb=b->child;ca && cb;ca=ca->next,cb=cb->next) if (!cJSON_Compare(ca,cb,ordered)) return 0;
+			return ca==cb;
+		case cJSON_Object:
+			/* Members are matched in step while they agree. From the first that does not, each member left in a must
+			   be held as often by b as by a, which pairs off members under a duplicated key whichever side is a. */
+			if (!ordered && cJSON_GetArraySize(a)!=cJSON_GetArraySize(b)) return 0;
+			for (ca=a->child,cb=b->child;ca && cb;ca=ca->next,cb=cb->next)
+			{
+				if (!ca->string || !key_equal(cb,ca->string,key_length(ca),1)) break;
+				if (!cJSON_Compare(ca,cb,ordered)) {if (ordered) return 0;break;}
+			}
+			if (ordered || !ca) return !ca && !cb;
+			for (;ca;ca=ca->next) if (!ca->string || !(n=count_equal(b,ca,ordered)) || n!=count_equal(a,ca,ordered)) return 0;
+			return 1;
+		default:			return 1;
+	}
+}
+
+/* Deduplication. The nodes are numbered depth first; pass one hashes every subtree bottom up, pass two walks top down,
+so a subtree is shared whole before its own parts are looked at, and a node kept as the original is never freed later.
+The tree is a fresh copy, so no reference points into what is freed. */
+struct dedupe_state {uint64_t *hashes;size_t *sizes;size_t next;cJSON **slots;size_t *at,mask,used;};
+
+static size_t dedupe_count(cJSON *item)
+{
+	cJSON *c;size_t n=1;
+	if (!packed_of(item)) for (c=item->child;c;c=c->next) n+=dedupe_count(c);
+	return n;
+}
+
+/* Hash item as dedupe_equal compares it, recording the hash and the size of its subtree under its number. */
+static uint64_t dedupe_hash(cJSON *item,struct dedupe_state *state)
+{
+	size_t at=state->next++;cJSON *c;struct cJSON_Packed *p=packed_of(item);uint64_t h=hash_mix(0x9e3779b97f4a7c15ULL,(uint64_t)(item->type&255)+1),v;
+	switch (item->type&255)
+	{
+		case cJSON_Number:	memcpy(&v,&item->valuedouble,sizeof(v));h=hash_mix(hash_mix(h,v),(uint64_t)item->valueint);break;
+		case cJSON_String:
+		case cJSON_Raw:		if (item->valuestring) h=hash_string(item->valuestring,string_length(item),h);break;
+		case cJSON_Array:
+		case cJSON_Object:
+			if (p) {h=hash_string((const char*)p->values,(size_t)p->count*sizeof(p->values[0]),hash_mix(h,(uint64_t)p->integers));break;}
+			for (c=item->child;c;c=c->next)
+			{
+				v=dedupe_hash(c,state);
+				h=hash_mix(h,c->string?hash_string(c->string,key_length(c),v):v);
+			}
+			break;
+	}
+	state->hashes[at]=h;state->sizes[at]=state->next-at;
+	return h;
+}
+
+/* Equal down to the bits of each number, the order of members and the case of keys, so either prints the same. */
+static int dedupe_equal(cJSON *a,cJSON *b)
+{
+	cJSON *ca,*cb;struct cJSON_Packed *pa,*pb;
+	if (a==b) return 1;
+	if ((a->type&255)!=(b->type&255)) return 0;
+	switch (a->type&255)
+	{
+		case cJSON_Number:	return !memcmp(&a->valuedouble,&b->valuedouble,sizeof(double)) && a->valueint==b->valueint;
+		case cJSON_String:
+		case cJSON_Raw:		return a->valuestring && b->valuestring && string_length(a)==string_length(b) && !memcmp(a->valuestring,b->valuestring,string_length(a));
+		case cJSON_Array:
+		case cJSON_Object:
+			pa=packed_of(a);pb=packed_of(b);
+			if (pa || pb) return pa && pb && pa->count==pb->count && pa->integers==pb->integers && !memcmp(pa->values,pb->values,(size_t)pa->count*sizeof(pa->values[0]));
+			if (a->child==b->child) return 1;
+			for (ca=a->child,cb=b->child;ca && cb;ca=ca->next,cb=cb->next)
+			{
+				if (!ca->string!=!cb->string || (ca->string && (key_length(ca)!=key_length(cb) || memcmp(ca->string,cb->string,key_length(ca))))) return 0;
+				if (!dedupe_equal(ca,cb)) return 0;
+			}
+			return !ca && !cb;
+		default:			return 1;
+	}
+}
+
+/* Make item a reference to the children or text of the equal node original, freeing its own. */
+static void dedupe_share(cJSON *item,cJSON *original)
+{
+	if (item->child) {cJSON_Delete(item->child);index_free(item);item->child=original->child;}
+	else {cJSON_free(item->valuestring);item->valuestring=original->valuestring;}
+	item->type|=cJSON_IsReference;
+}
+
+/* Double the table of kept nodes. Returns 0 without memory. */
+static int dedupe_grow(struct dedupe_state *state)
+{
+	size_t mask=2*state->mask+1,i,j;cJSON **slots=(cJSON**)cJSON_malloc((mask+1)*sizeof(cJSON*));size_t *at=(size_t*)cJSON_malloc((mask+1)*sizeof(size_t));
+	if (!slots || !at) {cJSON_free(slots);cJSON_free(at);return 0;}
+	memset(slots,0,(mask+1)*sizeof(cJSON*));
+	for (j=0;j<=state->mask;j++) if (state->slots[j])
+	{
+		for (i=state->hashes[state->at[j]]&mask;slots[i];i=(i+1)&mask);
+		slots[i]=state->slots[j];at[i]=state->at[j];
+	}
+	cJSON_free(state->slots);cJSON_free(state->at);
+	state->slots=slots;state->at=at;state->mask=mask;
+	return 1;
+}
+
+/* Share item if an equal node was kept before it, else keep it and go on to its children. */
+static void dedupe_walk(cJSON *item,struct dedupe_state *state)
+{
+	size_t at=state->next,i;cJSON *c;uint64_t h=state->hashes[at];
+	int container=((item->type&255)==cJSON_Array || (item->type&255)==cJSON_Object) && item->child && !(item->type&cJSON_IsPacked);
+	int text=((item->type&255)==cJSON_String || (item->type&255)==cJSON_Raw) && item->valuestring && !(item->type&cJSON_ValueIsInline);
+	state->next+=state->sizes[at];
+	if ((item->type&(cJSON_IsReference|cJSON_IsFrozen)) || (!container && !text)) return;
+	for (i=h&state->mask;state->slots[i];i=(i+1)&state->mask)
+		if (state->hashes[state->at[i]]==h && dedupe_equal(state->slots[i],item)) {dedupe_share(item,state->slots[i]);return;}
+	if (2*(state->used+1)<=state->mask+1 || dedupe_grow(state))	/* without memory the node is simply not kept */
+	{
+		for (i=h&state->mask;state->slots[i];i=(i+1)&state->mask);
+		state->slots[i]=item;state->at[i]=at;state->used++;
+	}
+	if (container) for (state->next=at+1,c=item->child;c;c=c->next) dedupe_walk(c,state);
+}
+
+/* Collapse the identical subtrees of item in place. Without memory it is left as it is. */
+static void dedupe_tree(cJSON *item)
+{
+	struct dedupe_state state;size_t nodes;int ready;
+	memset(&state,0,sizeof(state));
+	nodes=dedupe_count(item);state.mask=15;
+	state.hashes=(uint64_t*)cJSON_malloc(nodes*sizeof(uint64_t));state.sizes=(size_t*)cJSON_malloc(nodes*sizeof(size_t));
+	state.slots=(cJSON**)cJSON_malloc((state.mask+1)*sizeof(cJSON*));state.at=(size_t*)cJSON_malloc((state.mask+1)*sizeof(size_t));
+	ready=state.hashes && state.sizes && state.slots && state.at;
+	if (ready)
+	{
+		memset(state.slots,0,(state.mask+1)*sizeof(cJSON*));
+		dedupe_hash(item,&state);
+		state.next=0;dedupe_walk(item,&state);
+	}
+	cJSON_free(state.hashes);cJSON_free(state.sizes);cJSON_free(state.slots);cJSON_free(state.at);
+}
+
+/* The collapsed tree must never change, as a detached or replaced original would leave its references dangling, so it
+   is only ever handed out frozen. */
+cJSON *cJSON_Dedupe(cJSON *item,size_t *saved)
+{
+	cJSON *copy,*frozen;struct freeze_size size={0,0,0,0,0};struct pointers shared={0,0,0,0};size_t plain,shrunk;
+	if (saved) *saved=0;
+	if (!item || !(copy=cJSON_Duplicate(item,1))) return 0;
+	dedupe_tree(copy);
+	frozen=cJSON_Freeze(copy);cJSON_Delete(copy);
+	if (frozen && saved)	/* against the block cJSON_Freeze would make of item, never built */
+	{
+		plain=block_measure(item,&size,&shared);cJSON_free(shared.from);
+		shrunk=(size_t)((struct cJSON_Block*)frozen-1)->size;
+		*saved=plain>shrunk?plain-shrunk:0;
+	}
+	return frozen;
+}
+
+/* Compact documents. */
+typedef char cJSON_compact_node_size[sizeof(cJSON_CompactNode)==24?1:-1];
+/* A shape while compacting: the first object seen with it, and its offset in the shape words once written. */
+struct compact_shape {const cJSON *object;unsigned int hash;uint32_t count,at;};
+struct compact_shapes {struct compact_shape *list;size_t used,size;uint32_t *slots;size_t mask;};	/* slots hold list index+1 */
+struct compact_state {cJSON_CompactNode *nodes;uint32_t next;uint32_t *words;uint32_t used_words;char *pool;uint32_t used;struct compact_shapes *shapes;};
+
+/* Slots of the key table of a shape of count keys, at most half full. A shape is count, mask, the key offsets and the table. */
+static uint32_t compact_table(uint32_t count)	{uint32_t n=2;while (n<2*count) n<<=1;return n;}
+static uint64_t compact_shape_words(uint32_t count)	{return 2+(uint64_t)count+compact_table(count);}
+
+static int compact_same_keys(const cJSON *a,const cJSON *b)
+{
+	for (a=a->child,b=b->child;a && b;a=a->next,b=b->next)
+		if (key_length(a)!=key_length(b) || memcmp(a->string,b->string,key_length(a))) return 0;
+	return !a && !b;
+}
+
+/* The shape of object, added if new. 0 for an object with no members or a member without a key, or without memory (*oom). */
+static struct compact_shape *compact_shape_of(struct compact_shapes *shapes,const cJSON *object,int *oom)
+{
+	const cJSON *c;unsigned int hash=2166136261u;uint32_t count=0;size_t i,j;struct compact_shape *s;
+	for (c=object->child;c;c=c->next,count++)
+	{
+		if (!c->string) return 0;
+		hash=(hash^key_hash(c))*16777619u;
+	}
+	if (!count) return 0;
+	for (i=hash&shapes->mask;shapes->slots && shapes->slots[i];i=(i+1)&shapes->mask)
+	{
+		s=shapes->list+shapes->slots[i]-1;
+		if (s->hash==hash && s->count==count && compact_same_keys(s->object,object)) return s;
+	}
+	if (shapes->used==shapes->size)
+	{
+		size_t size=shapes->size?shapes->size*2:16;struct compact_shape *list=(struct compact_shape*)cJSON_malloc(size*sizeof(struct compact_shape));
+		uint32_t *slots=(uint32_t*)cJSON_malloc(2*size*sizeof(uint32_t));
+		if (!list || !slots) {cJSON_free(list);cJSON_free(slots);*oom=1;return 0;}
+		if (shapes->used) memcpy(list,shapes->list,shapes->used*sizeof(struct compact_shape));
+		memset(slots,0,2*size*sizeof(uint32_t));
+		for (j=0;j<shapes->used;j++)
+		{
+			for (i=list[j].hash&(2*size-1);slots[i];i=(i+1)&(2*size-1));
+			slots[i]=(uint32_t)j+1;
+		}
+		cJSON_free(shapes->list);cJSON_free(shapes->slots);
+		shapes->list=list;shapes->slots=slots;shapes->size=size;shapes->mask=2*size-1;
+		for (i=hash&shapes->mask;shapes->slots[i];i=(i+1)&shapes->mask);
+	}
+	s=shapes->list+shapes->used++;
+	s->object=object;s->hash=hash;s->count=count;s->at=0;
+	shapes->slots[i]=(uint32_t)shapes->used;
+	return s;
+}
+
+/* Count the nodes, the shape words and the bytes of text the compact copy of item needs. Keys of members of an object
+with a shape are counted once with the shape; the root keeps no key. */
+static int compact_measure(cJSON *item,int key,uint64_t *nodes,uint64_t *words,uint64_t *pool,struct compact_shapes *shapes)
+{
+	cJSON *c;struct cJSON_Packed *p=packed_of(item);struct compact_shape *s=0;size_t known=shapes->used;int oom=0;
+	(*nodes)++;
+	if (key && item->string) *pool+=key_length(item)+1;
+	if (p) {*nodes+=(uint64_t)p->count;return 1;}
+	if (value_text(item)) *pool+=string_length(item)+1;
+	if ((item->type&255)==cJSON_Object && !(s=compact_shape_of(shapes,item,&oom)) && oom) return 0;
+	if (s && shapes->used>known)
+	{
+		*words+=compact_shape_words(s->count);
+		for (c=item->child;c;c=c->next) *pool+=key_length(c)+1;
+	}
+	for (c=item->child;c;c=c->next) if (!compact_measure(c,!s,nodes,words,pool,shapes)) return 0;
+	return 1;
+}
+
+static uint32_t compact_text(const char *str,size_t len,struct compact_state *state)
+{
+	uint32_t at=state->used;
+	memcpy(state->pool+at,str,len+1);state->used+=(uint32_t)len+1;
+	return at;
+}
+
+/* Write the keys and key table of shape s, taken from its first object, on first use. */
+static uint32_t compact_shape_write(struct compact_shape *s,struct compact_state *state)
+{
+	const cJSON *c;uint32_t *w,*table,mask,i,j;size_t len;
+	if (s->at) return s->at;
+	s->at=state->used_words;w=state->words+s->at;
+	mask=compact_table(s->count)-1;table=w+2+s->count;
+	w[0]=s->count;w[1]=mask;
+	for (c=s->object->child,i=0;c;c=c->next,i++)
+	{
+		w[2+i]=compact_text(c->string,key_length(c),state);
+		for (j=cJSON_hash(c->string,&len)&mask;table[j];j=(j+1)&mask);
+		table[j]=i+1;
+	}
+	state->used_words+=(uint32_t)compact_shape_words(s->count);
+	return s->at;
+}
+
+/* Fill node from item, giving its children the next free run of nodes before filling them in turn. */
+static void compact_fill(cJSON *item,cJSON_CompactNode *node,int key,struct compact_state *state)
+{
+	cJSON *c;cJSON_CompactNode *n;struct cJSON_Packed *p=packed_of(item);struct compact_shape *s=0;uint32_t i,count=0,*keys=0;size_t len;int oom=0;
+	node->type=item->type&255;
+	if (key && item->string) node->key=compact_text(item->string,key_length(item),state);
+	if ((item->type&255)==cJSON_Number) node->value.number=item->valuedouble;
+	else if (value_text(item))
+	{
+		len=string_length(item);
+		node->value.string=compact_text(item->valuestring,len,state);node->count=(uint32_t)len;
+	}
+	if (p)
+	{
+		node->child=state->next;node->count=(uint32_t)p->count;state->next+=node->count;
+		for (i=0,n=state->nodes+node->child;i<node->count;i++,n++)
+		{
+			n->type=cJSON_Number;
+			if (p->integers) n->type|=cJSON_IsInteger,n->value.integer=p->values[i].i;
+			else n->value.number=p->values[i].d;
+		}
+		return;
+	}
+	if ((item->type&255)==cJSON_Object && (s=compact_shape_of(state->shapes,item,&oom)))	/* every shape was found while measuring */
+	{
+		node->value.shape=compact_shape_write(s,state);
+		keys=state->words+node->value.shape+2;
+	}
+	for (c=item->child;c;c=c->next) count++;
+	if (!count) return;
+	node->child=state->next;node->count=count;state->next+=count;
+	for (i=0,c=item->child;c;c=c->next,i++)
+	{
+		n=state->nodes+node->child+i;
+		compact_fill(c,n,!keys,state);
+		if (keys) n->key=keys[i];
+	}
+}
+
+cJSON_Compact *cJSON_CompactTree(cJSON *item)
+{
+	uint64_t nodes=0,words=1,pool=1;cJSON_Compact *doc=0;struct compact_state state;struct compact_shapes shapes={0,0,0,0,0};size_t fixed;
+	if (!item) return 0;
+	if (!compact_measure(item,0,&nodes,&words,&pool,&shapes) || nodes>UINT32_MAX || words>UINT32_MAX || pool>UINT32_MAX) goto done;
+	fixed=sizeof(cJSON_Compact)+(size_t)nodes*sizeof(cJSON_CompactNode)+(size_t)words*sizeof(uint32_t);
+	if (!(doc=(cJSON_Compact*)cJSON_malloc(fixed+(size_t)pool))) goto done;
+	memset(doc,0,fixed);
+	doc->nodes=(uint32_t)nodes;doc->shapes=(uint32_t)shapes.used;doc->words=(uint32_t)words;doc->pool=(uint32_t)pool;
+	state.nodes=(cJSON_CompactNode*)(doc+1);state.next=1;state.shapes=&shapes;
+	state.words=(uint32_t*)(state.nodes+nodes);state.used_words=1;	/* offset 0 is no shape */
+	state.pool=(char*)(state.words+words);state.pool[0]=0;state.used=1;	/* offset 0 is no key */
+	compact_fill(item,state.nodes,0,&state);
+done:
+	cJSON_free(shapes.list);cJSON_free(shapes.slots);
+	return doc;
+}
+
+cJSON_Compact *cJSON_ParseCompact(const char *value)
+{
+	cJSON *tree=cJSON_Parse(value);cJSON_Compact *doc;
+	if (!tree) return 0;
+	doc=cJSON_CompactTree(tree);cJSON_Delete(tree);
+	return doc;
+}
+
+void cJSON_DeleteCompact(cJSON_Compact *doc)	{if (doc) cJSON_free(doc);}
+size_t cJSON_CompactSize(const cJSON_Compact *doc)	{return doc?sizeof(cJSON_Compact)+(size_t)doc->nodes*sizeof(cJSON_CompactNode)+(size_t)doc->words*sizeof(uint32_t)+doc->pool:0;}
+size_t cJSON_CompactShapes(const cJSON_Compact *doc)	{return doc?doc->shapes:0;}
+const cJSON_CompactNode *cJSON_CompactRoot(const cJSON_Compact *doc)	{return doc?(const cJSON_CompactNode*)(doc+1):0;}
+static const uint32_t *compact_words(const cJSON_Compact *doc)	{return (const uint32_t*)(cJSON_CompactRoot(doc)+doc->nodes);}
+static const char *compact_pool(const cJSON_Compact *doc)	{return (const char*)(compact_words(doc)+doc->words);}
+
+const cJSON_CompactNode *cJSON_CompactItem(const cJSON_Compact *doc,const cJSON_CompactNode *node,int item)
+{
+	if (!doc || !node || ((node->type&255)!=cJSON_Array && (node->type&255)!=cJSON_Object)) return 0;
+	if (item<0 || (uint32_t)item>=node->count) return 0;
+	return cJSON_CompactRoot(doc)+node->child+item;
+}
+
+/* Position of member "string" in the shape of object, the first of equal keys, or object->count if there is none. */
+static uint32_t compact_position(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string,int case_sensitive)
+{
+	const cJSON_CompactNode *c;const char *pool=compact_pool(doc);const uint32_t *w,*table;uint32_t i,mask,found=object->count;size_t len;
+	if (!object->value.shape)
+	{
+		for (i=0,c=cJSON_CompactRoot(doc)+object->child;i<object->count;i++,c++)
+			if (case_sensitive?!strcmp(pool+c->key,string):!cJSON_strcasecmp(pool+c->key,string)) return i;
+		return found;
+	}
+	w=compact_words(doc)+object->value.shape;mask=w[1];table=w+2+w[0];
+	for (i=cJSON_hash(string,&len)&mask;table[i];i=(i+1)&mask)
+		if (table[i]-1<found && (case_sensitive?!strcmp(pool+w[2+table[i]-1],string):!cJSON_strcasecmp(pool+w[2+table[i]-1],string))) found=table[i]-1;
+	return found;
+}
+
+static const cJSON_CompactNode *compact_find(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string,int case_sensitive)
+{
+	uint32_t i;
+	if (!doc || !object || (object->type&255)!=cJSON_Object || !string) return 0;
+	i=compact_position(doc,object,string,case_sensitive);
+	return i<object->count?cJSON_CompactRoot(doc)+object->child+i:0;
+}
+const cJSON_CompactNode *cJSON_CompactObjectItem(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string)				{return compact_find(doc,object,string,0);}
+const cJSON_CompactNode *cJSON_CompactObjectItemCaseSensitive(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string)	{return compact_find(doc,object,string,1);}
+
+const cJSON_CompactNode *cJSON_CompactObjectItemSlot(const cJSON_Compact *doc,const cJSON_CompactNode *object,const char *string,cJSON_CompactSlot *slot)
+{
+	if (!doc || !object || (object->type&255)!=cJSON_Object || !string || !slot) return 0;
+	if (!object->value.shape || slot->shape!=object->value.shape)
+	{
+		slot->shape=object->value.shape;
+		slot->position=compact_position(doc,object,string,0);
+	}
+	return slot->position<object->count?cJSON_CompactRoot(doc)+object->child+slot->position:0;
+}
+
+const char *cJSON_CompactKey(const cJSON_Compact *doc,const cJSON_CompactNode *node)	{return doc && node && node->key?compact_pool(doc)+node->key:0;}
+const char *cJSON_CompactString(const cJSON_Compact *doc,const cJSON_CompactNode *node)
+{
+	if (!doc || !node || ((node->type&255)!=cJSON_String && (node->type&255)!=cJSON_Raw)) return 0;
+	return compact_pool(doc)+node->value.string;
+}
+double cJSON_CompactDouble(const cJSON_CompactNode *node)	{return node->type&cJSON_IsInteger?(double)node->value.integer:node->value.number;}
+int64_t cJSON_CompactInt64(const cJSON_CompactNode *node)	{return node->type&cJSON_IsInteger?node->value.integer:(int64_t)node->value.number;}
+
+cJSON *cJSON_CompactExpand(const cJSON_Compact *doc,const cJSON_CompactNode *node)
+{
+	cJSON *item=0,*child,*prev=0;uint32_t i;
+	if (!doc || !node) return 0;
+	switch (node->type&255)
+	{
+		case cJSON_NULL:	return cJSON_CreateNull();
+		case cJSON_False:	return cJSON_CreateFalse();
+		case cJSON_True:	return cJSON_CreateTrue();
+		case cJSON_Number:	if ((item=cJSON_CreateNumber(cJSON_CompactDouble(node)))) item->valueint=cJSON_CompactInt64(node);return item;
+		case cJSON_String:	return cJSON_CreateStringWithLength(cJSON_CompactString(doc,node),node->count);
+		case cJSON_Raw:		return cJSON_CreateRaw(cJSON_CompactString(doc,node));
+		case cJSON_Array:	item=cJSON_CreateArray();break;
+		case cJSON_Object:	item=cJSON_CreateObject();break;
+		default:			return 0;
+	}
+	for (i=0;item && i<node->count;i++)
+	{
+		const cJSON_CompactNode *c=cJSON_CompactRoot(doc)+node->child+i;
+		if (!(child=cJSON_CompactExpand(doc,c)) || (c->key && !cJSON_SetItemKey(child,compact_pool(doc)+c->key))) {cJSON_Delete(child);cJSON_Delete(item);return 0;}
+		if (prev) suffix_object(prev,child); else item->child=child;
+		prev=child;
+	}
+	return item;
+}
@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/*
+ * The checks every test shares. A failed CHECK reports where it failed and the
+ * test goes on, main() returns non-zero if any failed.
+ */
+
+#ifndef JSON__TESTS_CHECK_H_
+#define JSON__TESTS_CHECK_H_
+
+#include <JSON/Exception.h>
+
+#include <iostream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { if(!(cond)) { std::cerr << __FILE__ << ":" << __LINE__ << ": " << #cond << std::endl; ++failures; } } while(0)
+
+/**
+ * true if running the statement throws a JSON::Exception
+ */
+#define THROWS(stmt) \
+    ([&]() -> bool { try { stmt; } catch(const JSON::Exception&) { return true; } return false; }())
+
+#endif /* JSON__TESTS_CHECK_H_ */
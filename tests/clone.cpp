@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Copies taken with getJSONObject(..., true), optJSONObject(..., true) and
+ * put() of a view are independent of the tree they came from, whatever views
+ * of either exist, and taking them only reads the source.
+ */
+
+#include <JSON/Array.h>
+#include <JSON/Exception.h>
+#include <JSON/Object.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+static const char* const text = "{\"x\":{\"y\":1,\"z\":[{\"w\":1},{\"w\":2}]},\"list\":[1,2,3]}";
+
+static void
+viewBeforeCopy()
+{
+    JSON::Object a(text);
+    JSON::Object x;
+    JSON::Array z;
+    a.getJSONObject("x", x).getJSONArray("z", z);
+    JSON::Object z0;
+    z.getJSONObject(0, z0);
+
+    JSON::Object c;
+    a.getJSONObject("x", c, true);
+    z0.put("w", 10);
+
+    JSON::Array cz;
+    JSON::Object c0;
+    c.getJSONArray("z", cz).getJSONObject(0, c0);
+    CHECK(c0.getInt<int>("w") == 1);
+    CHECK(z0.getInt<int>("w") == 10);
+}
+
+static void
+putView()
+{
+    JSON::Object a(text);
+    JSON::Object ax;
+    a.getJSONObject("x", ax);
+
+    JSON::Object b;
+    b.put("copy", ax);
+    ax.put("y", 3);
+
+    JSON::Object bx;
+    b.getJSONObject("copy", bx);
+    CHECK(bx.getInt<int>("y") == 1);
+
+    bx.put("y", 4);
+    CHECK(ax.getInt<int>("y") == 3);
+}
+
+static void
+optionalCopy()
+{
+    JSON::Array a("[1,{\"w\":1},[2]]");
+    const std::string before = a.toString();
+
+    JSON::Object o;
+    JSON::Array l;
+    CHECK(&a.optJSONObject(0, o, true) == &JSON::Object::Null);
+    CHECK(&a.optJSONArray(1, l, true) == &JSON::Array::Null);
+    CHECK(a.length() == 3 && a.toString() == before);
+
+    a.optJSONObject(1, o, true).put("w", 2);
+    a.optJSONArray(2, l, true).append(3.0);
+    CHECK(a.toString() == before);
+    CHECK(o.getInt<int>("w") == 2 && l.length() == 2);
+
+    JSON::Object b(text);
+    const std::string original = b.toString();
+    CHECK(&b.optJSONArray("x", l, true) == &JSON::Array::Null);
+    CHECK(&b.optJSONObject("list", o, true) == &JSON::Object::Null);
+    b.optJSONArray("list", l, true).append(4.0);
+    CHECK(b.toString() == original);
+}
+
+static void
+concurrentCopies()
+{
+    std::string big = "{\"items\":[";
+    for(int i = 0; i < 500; ++i)
+        big += (i ? ",{\"id\":" : "{\"id\":") + std::to_string(i) + ",\"tags\":[\"a\",\"b\"]}";
+    big += "]}";
+
+    const JSON::Object shared(big);
+    const std::string before = shared.toString();
+    std::atomic<int> bad(0);
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared, &before, &bad]()
+        {
+            for(int i = 0; i < 50; ++i)
+            {
+                JSON::Array items;
+                shared.getJSONArray("items", items, true);
+                JSON::Object first;
+                items.getJSONObject(0, first).put("id", -1);
+
+                JSON::Object copy;
+                copy.put("items", items);
+                if(copy.getJSONArray("items", items).length() != 500 || shared.toString() != before)
+                    ++bad;
+            }
+        });
+    }
+    for(auto& thread : threads)
+        thread.join();
+
+    CHECK(bad == 0);
+    CHECK(shared.toString() == before);
+}
+
+int
+main()
+{
+    viewBeforeCopy();
+    putView();
+    optionalCopy();
+    concurrentCopies();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * cJSON_Compare of objects in any order is symmetric, also when a key is
+ * repeated, and agrees with cJSON_Hash.
+ */
+
+#include <JSON/cJSON/cJSON.h>
+
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+/* cJSON_Compare of a and b both ways, which must agree */
+static int
+compare(const std::string& a, const std::string& b, int ordered = 0)
+{
+    cJSON* ta = cJSON_Parse(a.c_str());
+    cJSON* tb = cJSON_Parse(b.c_str());
+    int ab = cJSON_Compare(ta, tb, ordered);
+    int ba = cJSON_Compare(tb, ta, ordered);
+    if(ab != ba)
+        std::cerr << a << " against " << b << ": " << ab << " one way, " << ba << " the other" << std::endl;
+    if(ab && cJSON_Hash(ta, 1, ordered) != cJSON_Hash(tb, 1, ordered))
+        std::cerr << a << " equals " << b << " but hashes differently" << std::endl;
+    int same = ab == ba && (!ab || cJSON_Hash(ta, 1, ordered) == cJSON_Hash(tb, 1, ordered));
+    cJSON_Delete(ta);
+    cJSON_Delete(tb);
+    return same ? ab : -1;
+}
+
+/* an object of n members, two of them under the key "dup" */
+static std::string
+large(int n, const std::string& first, const std::string& second, bool reversed)
+{
+    std::string text = "{";
+    for(int i = 0; i < n; ++i)
+    {
+        int k = reversed ? n - 1 - i : i;
+        text += std::string(i ? "," : "") + "\"key" + std::to_string(k) + "\":" + std::to_string(k);
+    }
+    text += ",\"dup\":" + (reversed ? second : first) + ",\"dup\":" + (reversed ? first : second) + "}";
+    return text;
+}
+
+int
+main()
+{
+    CHECK(compare("{\"x\":1,\"x\":1}", "{\"x\":1,\"y\":2}") == 0);
+    CHECK(compare("{\"x\":1,\"y\":2}", "{\"y\":2,\"x\":1}") == 1);
+    CHECK(compare("{\"x\":1,\"y\":2}", "{\"y\":2,\"x\":1}", 1) == 0);
+    CHECK(compare("{\"x\":1,\"x\":2}", "{\"x\":2,\"x\":1}") == 1);
+    CHECK(compare("{\"x\":1,\"x\":2}", "{\"x\":2,\"x\":2}") == 0);
+    CHECK(compare("{\"x\":1,\"x\":1,\"y\":[1,{\"z\":0}]}", "{\"y\":[1,{\"z\":0}],\"x\":1,\"x\":1}") == 1);
+    CHECK(compare("{\"a\":{\"x\":1,\"x\":1}}", "{\"a\":{\"x\":1,\"y\":1}}") == 0);
+    CHECK(compare("{\"x\":1}", "{\"X\":1}") == 0);
+
+    /* large enough for the key table */
+    CHECK(compare(large(40, "1", "2", false), large(40, "1", "2", true)) == 1);
+    CHECK(compare(large(40, "1", "1", false), large(40, "1", "2", true)) == 0);
+    CHECK(compare(large(40, "[1]", "{}", false), large(40, "[1]", "{}", true)) == 1);
+    CHECK(compare(large(40, "[1]", "[1]", false), large(40, "[1]", "{}", true)) == 0);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * cJSON_Dedupe hands out a frozen copy, so nothing can detach or replace an
+ * original that references in it point at, and counts what it saves against
+ * the frozen copy made without sharing.
+ */
+
+#include <JSON/Object.h>
+#include <JSON/cJSON/cJSON.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+static std::string
+print(cJSON* item)
+{
+    char* text = cJSON_PrintUnformatted(item);
+    std::string printed(text);
+    cJSON_free(text);
+    return printed;
+}
+
+int
+main()
+{
+    std::string text = "[";
+    for(int i = 0; i < 50; ++i)
+        text += std::string(i ? "," : "") + "{\"address\":{\"street\":\"1 Long Infinite Loop Road\",\"geo\":[37.33,-122.03]},\"id\":" + std::to_string(i) + "}";
+    text += "]";
+
+    cJSON* tree = cJSON_Parse(text.c_str());
+    const std::string before = print(tree);
+
+    size_t saved = 0;
+    cJSON* deduped = cJSON_Dedupe(tree, &saved);
+    CHECK(deduped != 0);
+    CHECK(saved > 0);
+    CHECK(deduped->type & cJSON_IsFrozen);
+    CHECK(print(tree) == before);
+    CHECK(print(deduped) == before);
+    CHECK(cJSON_GetArrayItem(cJSON_GetArrayItem(deduped, 7), 0)->type & cJSON_IsReference);
+
+    /* saved is the difference between the two frozen blocks, as their images show */
+    cJSON* frozen = cJSON_Freeze(tree);
+    size_t plain = 0, shrunk = 0;
+    cJSON_free(cJSON_Snapshot(frozen, &plain));
+    cJSON_free(cJSON_Snapshot(deduped, &shrunk));
+    CHECK(plain > shrunk && saved == plain - shrunk);
+    cJSON_Delete(frozen);
+
+    /* the original of every shared address stays where it is */
+    cJSON_DeleteItemFromArray(deduped, 0);
+    cJSON* null = cJSON_CreateNull();
+    cJSON_ReplaceItemInArray(deduped, 1, null);
+    CHECK(cJSON_GetArrayItem(deduped, 1) != null);
+    cJSON_Delete(null);
+    CHECK(cJSON_GetArraySize(deduped) == 50);
+    CHECK(print(deduped) == before);
+
+    cJSON_DeleteItemFromArray(tree, 0);
+    CHECK(cJSON_GetArraySize(tree) == 49);
+    CHECK(cJSON_Compare(cJSON_GetArrayItem(deduped, 1), cJSON_GetArrayItem(tree, 0), 1));
+
+    cJSON_Delete(tree);
+    cJSON_Delete(deduped);
+
+    JSON::Object object("{\"a\":{\"x\":\"a string long enough for the heap\"},\"b\":{\"x\":\"a string long enough for the heap\"}}");
+    JSON::Object copy(object);
+    CHECK(object.dedupe() > 0);
+    CHECK(object == copy);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * A hash kept by a container must follow changes made anywhere below it, and
+ * match the hash of the same document parsed afresh.
+ */
+
+#include <JSON/cJSON/cJSON.h>
+
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+/* the hash of item printed and parsed again, which has nothing cached */
+static uint64_t
+fresh(cJSON* item, uint64_t seed, int ordered)
+{
+    char* text = cJSON_PrintUnformatted(item);
+    cJSON* copy = cJSON_Parse(text);
+    cJSON_free(text);
+    uint64_t h = cJSON_Hash(copy, seed, ordered);
+    cJSON_Delete(copy);
+    return h;
+}
+
+int
+main()
+{
+    std::string text = "[";
+    for(int i = 0; i < 20; ++i)
+    {
+        text += std::string(i ? "," : "") + "{\"id\":" + std::to_string(i) + ",\"values\":[";
+        for(int j = 0; j < 20; ++j)
+            text += std::string(j ? "," : "") + std::to_string(i * j);
+        text += "]}";
+    }
+    text += "]";
+
+    cJSON* doc = cJSON_Parse(text.c_str());
+    const uint64_t before = cJSON_Hash(doc, 0, 0);
+    CHECK(cJSON_Hash(doc, 0, 0) == before);
+    CHECK(before == fresh(doc, 0, 0));
+
+    /* a change two levels down, made without the root */
+    cJSON* values = cJSON_GetObjectItem(cJSON_GetArrayItem(doc, 5), "values");
+    CHECK(cJSON_Hash(values, 0, 0) == fresh(values, 0, 0));
+    cJSON_Delete(cJSON_DetachItemFromArray(values, 3));
+    CHECK(cJSON_Hash(doc, 0, 0) != before);
+    CHECK(cJSON_Hash(doc, 0, 0) == fresh(doc, 0, 0));
+    CHECK(cJSON_Hash(values, 0, 0) == fresh(values, 0, 0));
+
+    cJSON_AddItemToArray(values, cJSON_CreateNumber(3 * 5));
+    CHECK(cJSON_Hash(doc, 0, 0) == fresh(doc, 0, 0));
+    cJSON_ReplaceItemInArray(values, 0, cJSON_CreateString("zero"));
+    CHECK(cJSON_Hash(doc, 0, 0) == fresh(doc, 0, 0));
+    CHECK(cJSON_Hash(doc, 7, 1) == fresh(doc, 7, 1));
+
+    /* a change to another document leaves this one's hash alone */
+    cJSON* other = cJSON_Parse(text.c_str());
+    const uint64_t kept = cJSON_Hash(doc, 0, 0);
+    cJSON_Delete(cJSON_DetachItemFromArray(other, 0));
+    CHECK(cJSON_Hash(doc, 0, 0) == kept);
+    cJSON_Delete(other);
+
+    /* a frozen tree keeps its hash */
+    cJSON* frozen = cJSON_Freeze(doc);
+    CHECK(cJSON_Hash(frozen, 0, 0) == kept);
+    CHECK(cJSON_Hash(frozen, 0, 0) == kept);
+    CHECK(cJSON_Hash(frozen, 3, 1) == cJSON_Hash(doc, 3, 1));
+    cJSON_Delete(frozen);
+
+    cJSON_Delete(doc);
+    return failures ? 1 : 0;
+}
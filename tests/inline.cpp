@@ -0,0 +1,122 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Short keys and short string values are kept in the node, each in a value
+ * field its type leaves unused, so a member with both costs one allocation
+ * and every other field still reads as before.
+ */
+
+#include <JSON/cJSON/cJSON.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+static int allocations = 0;
+
+static void*
+counting_malloc(size_t size)
+{
+    ++allocations;
+    return malloc(size);
+}
+
+static const char* text =
+    "{\"n\":1.5,\"s\":\"abc\",\"t\":true,\"f\":false,\"z\":null,\"a\":[2],\"o\":{\"k\":\"v\"},\"r\":\"a long value string\"}";
+
+static void
+members(cJSON* object)
+{
+    cJSON* n = cJSON_GetObjectItem(object, "n");
+    CHECK(n && n->valuedouble == 1.5 && n->valueint == 1 && cJSON_GetStringLength(n) == 0);
+    CHECK(n && !strcmp(n->string, "n") && cJSON_GetKeyLength(n) == 1);
+    cJSON* s = cJSON_GetObjectItem(object, "s");
+    CHECK(s && !strcmp(s->valuestring, "abc") && cJSON_GetStringLength(s) == 3 && !strcmp(s->string, "s"));
+    CHECK(cJSON_GetObjectItem(object, "t") && (cJSON_GetObjectItem(object, "t")->type & 255) == cJSON_True);
+    CHECK(cJSON_GetObjectItem(object, "z") && (cJSON_GetObjectItem(object, "z")->type & 255) == cJSON_NULL);
+    cJSON* a = cJSON_GetObjectItem(object, "a");
+    CHECK(a && cJSON_GetArraySize(a) == 1 && cJSON_GetArrayItem(a, 0)->valueint == 2);
+    cJSON* o = cJSON_GetObjectItem(object, "o");
+    CHECK(o && !strcmp(cJSON_GetObjectItem(o, "k")->valuestring, "v"));
+    cJSON* r = cJSON_GetObjectItem(object, "r");
+    CHECK(r && !strcmp(r->valuestring, "a long value string") && !strcmp(r->string, "r"));
+}
+
+int
+main()
+{
+    if(sizeof(void*) == 8)
+        CHECK(sizeof(cJSON) == 64);
+
+    cJSON_Hooks hooks = { counting_malloc, free };
+    cJSON_InitHooks(&hooks);
+    cJSON* parsed = cJSON_Parse(text);
+    // one node each, the object inside "o" has one more, and the long value its own string
+    CHECK(allocations == 12);
+    cJSON_InitHooks(0);
+    members(parsed);
+    for(cJSON* c = parsed->child; c; c = c->next)
+        CHECK((c->type & cJSON_StringIsInline) && c->string >= (char*)c && c->string < (char*)(c + 1));
+    CHECK(cJSON_GetObjectItem(parsed, "s")->type & cJSON_ValueIsInline);
+
+    char* printed = cJSON_PrintUnformatted(parsed);
+    cJSON* again = cJSON_Parse(printed);
+    CHECK(cJSON_Compare(parsed, again, 1));
+    free(printed);
+
+    cJSON* copy = cJSON_Duplicate(parsed, 1);
+    members(copy);
+    cJSON* frozen = cJSON_Freeze(parsed);
+    members(frozen);
+
+    // a reference leaves the key of what it refers to behind
+    cJSON* holder = cJSON_CreateObject();
+    cJSON_AddItemReferenceToObject(holder, "number", cJSON_GetObjectItem(parsed, "n"));
+    cJSON_AddItemReferenceToArray(holder, cJSON_GetObjectItem(parsed, "a"));
+    cJSON* ref = cJSON_GetObjectItem(holder, "number");
+    CHECK(ref && ref->valuedouble == 1.5 && cJSON_GetKeyLength(ref) == 6);
+    CHECK(holder->child->next && !holder->child->next->string && cJSON_GetArraySize(holder->child->next) == 1);
+
+    // renaming moves a key between the node and the heap
+    cJSON* n = cJSON_GetObjectItem(copy, "n");
+    CHECK(cJSON_SetItemKey(n, "a much longer key") && !(n->type & cJSON_StringIsInline));
+    CHECK(cJSON_GetObjectItem(copy, "a much longer key") == n && n->valuedouble == 1.5);
+    CHECK(cJSON_SetItemKey(n, "m") && (n->type & cJSON_StringIsInline) && n->valuedouble == 1.5);
+    CHECK(cJSON_GetObjectItem(copy, "m") == n);
+
+    cJSON_Delete(holder);
+    cJSON_Delete(frozen);
+    cJSON_Delete(copy);
+    cJSON_Delete(again);
+    cJSON_Delete(parsed);
+
+    return failures ? 1 : 0;
+}
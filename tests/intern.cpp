@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * A thread interning keys frees its table when it ends, whether or not it
+ * turned interning off.
+ */
+
+#include <JSON/cJSON/cJSON.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+
+static std::atomic<long> live(0);
+
+static void*
+counted_malloc(size_t size)
+{
+    size_t* block = static_cast<size_t*>(std::malloc(size + sizeof(max_align_t)));
+    if(0 == block)
+        return 0;
+    *block = size;
+    live += size;
+    return reinterpret_cast<char*>(block) + sizeof(max_align_t);
+}
+
+static void
+counted_free(void* ptr)
+{
+    if(0 == ptr)
+        return;
+    size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - sizeof(max_align_t));
+    live -= *block;
+    std::free(block);
+}
+
+static void
+intern(bool turnOff)
+{
+    cJSON_InternKeys(1);
+    for(int i = 0; i < 10; ++i)
+    {
+        cJSON* tree = cJSON_Parse("[{\"a key long enough to intern\":1},{\"a key long enough to intern\":2}]");
+        cJSON_AddItemToObject(cJSON_GetArrayItem(tree, 0), "another key long enough to intern", cJSON_CreateNull());
+        cJSON_Delete(tree);
+    }
+    if(turnOff)
+        cJSON_InternKeys(0);
+}
+
+int
+main()
+{
+    cJSON_Hooks hooks = { counted_malloc, counted_free };
+    cJSON_InitHooks(&hooks);
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 8; ++i)
+        threads.emplace_back(intern, i % 2 == 0);
+    for(auto& thread : threads)
+        thread.join();
+
+    CHECK(live == 0);
+
+    return failures ? 1 : 0;
+}
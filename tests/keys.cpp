@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Members named by setting ->string directly are found by their text, and
+ * cJSON_Rekey brings an object up to date after its lists are changed by hand.
+ */
+
+#include <JSON/cJSON/cJSON.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+static char*
+copy(const char* text)
+{
+    char* str = (char*)cJSON_malloc(strlen(text) + 1);
+    strcpy(str, text);
+    return str;
+}
+
+static std::string
+print(cJSON* item)
+{
+    char* text = cJSON_PrintUnformatted(item);
+    std::string printed(text);
+    cJSON_free(text);
+    return printed;
+}
+
+/* a member named by hand, the way code written for plain cJSON does it */
+static cJSON*
+member(const char* key, double value)
+{
+    cJSON* item = cJSON_CreateNumber(value);
+    item->string = copy(key);
+    return item;
+}
+
+/* allocations fail while set, to run out of memory copying a key */
+static bool starve = false;
+
+static void*
+starving_malloc(size_t size)
+{
+    return starve ? 0 : malloc(size);
+}
+
+int
+main()
+{
+    /* small object, linked by hand */
+    cJSON* small = cJSON_CreateObject();
+    small->child = member("name", 1);
+    CHECK(cJSON_GetObjectItem(small, "name") == small->child);
+    CHECK(cJSON_GetObjectItemCaseSensitive(small, "NAME") == 0);
+    CHECK(cJSON_GetKeyLength(small->child) == 4);
+    CHECK(print(small) == "{\"name\":1}");
+    cJSON* parsed = cJSON_Parse("{\"name\":1}");
+    CHECK(cJSON_Compare(small, parsed, 1));
+    CHECK(cJSON_Hash(small, 0, 0) == cJSON_Hash(parsed, 0, 0));
+    cJSON* dup = cJSON_Duplicate(small, 1);
+    CHECK(cJSON_GetObjectItem(dup, "name") != 0);
+    cJSON_Delete(dup);
+    cJSON_Delete(parsed);
+    cJSON_Delete(small);
+
+    /* large object, with its key table */
+    cJSON* large = cJSON_CreateObject();
+    for(int i = 0; i < 40; ++i)
+        cJSON_AddNumberToObject(large, ("a rather long member name " + std::to_string(i)).c_str(), i);
+    CHECK(cJSON_GetObjectItem(large, "a rather long member name 39") != 0);
+    cJSON_AddItemToArray(large, member("added by hand", 40));
+    CHECK(cJSON_GetObjectItem(large, "added by hand") != 0);
+    cJSON_Delete(cJSON_DetachItemFromObject(large, "added by hand"));
+    CHECK(cJSON_GetObjectItem(large, "added by hand") == 0);
+    CHECK(cJSON_GetArraySize(large) == 40);
+
+    /* rename one member and move the last to the front, by hand */
+    cJSON* renamed = cJSON_GetArrayItem(large, 5);
+    cJSON_free(renamed->string);
+    renamed->string = copy("renamed by hand");
+    cJSON* last = cJSON_GetArrayItem(large, 39);
+    last->prev->next = 0;
+    last->next = large->child;
+    large->child = last;
+    cJSON_Rekey(large);
+
+    CHECK(cJSON_GetObjectItem(large, "renamed by hand") == renamed);
+    CHECK(cJSON_GetObjectItem(large, "a rather long member name 5") == 0);
+    CHECK(cJSON_GetArrayItem(large, 0) == last);
+    CHECK(cJSON_GetArrayItem(large, 6) == renamed);
+    CHECK(cJSON_GetArrayItem(large, 39)->valuedouble == 38);
+    CHECK(cJSON_GetArraySize(large) == 40);
+    CHECK(large->child->next->prev == large->child);
+    cJSON_DeleteItemFromObject(large, "renamed by hand");
+    CHECK(cJSON_GetArraySize(large) == 39);
+    CHECK(cJSON_GetObjectItem(large, "a rather long member name 6") == cJSON_GetArrayItem(large, 6));
+    cJSON_Delete(large);
+
+    /* a key that cannot be copied leaves the new item unlinked, with the caller */
+    cJSON_Hooks hooks = { starving_malloc, free };
+    cJSON_InitHooks(&hooks);
+    cJSON* object = cJSON_Parse("{\"a member name long enough for the heap\":1}");
+    cJSON* kept = object->child;
+    cJSON* item = cJSON_CreateNumber(2);
+    starve = true;
+    cJSON_ReplaceItemInObject(object, "a member name long enough for the heap", item);
+    cJSON_SetItemInObject(object, "a member name long enough for the heap", item);
+    cJSON_AddItemToObject(object, "another member name long enough for the heap", item);
+    starve = false;
+    CHECK(item->string == 0);
+    CHECK(item->prev == 0 && item->next == 0);
+    CHECK(object->child == kept && kept->next == 0);
+    CHECK(print(object) == "{\"a member name long enough for the heap\":1}");
+    cJSON_Delete(item);
+    cJSON_Delete(object);
+    cJSON_InitHooks(0);
+
+    return failures ? 1 : 0;
+}
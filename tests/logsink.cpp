@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Every LogSink entry is one line, whatever raw JSON it holds, and each line
+ * parses back.
+ */
+
+#include <JSON/LogSink.h>
+#include <JSON/Object.h>
+#include <JSON/RawJSON.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "check.h"
+
+int
+main()
+{
+    char path[] = "/tmp/logsinkXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+
+    const JSON::RawJSON multiline("{\n  \"a\": [1,\r\n    2]\n}");
+    {
+        JSON::LogSink sink(fd);
+        sink.log(multiline);
+
+        JSON::LogSink::Record record;
+        record.put("n", 1).put("raw", multiline).put("s", "two\nlines");
+        sink.log(record);
+
+        JSON::Object obj;
+        obj.put("raw", multiline);
+        obj.put("s", "two\nlines");
+        sink.log(obj);
+        sink.flush();
+    }
+    close(fd);
+
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(in, line);)
+        lines.push_back(line);
+    unlink(path);
+
+    CHECK(lines.size() == 3);
+    for(size_t i = 0; i < lines.size(); ++i)
+    {
+        CHECK(lines[i].find('\r') == std::string::npos);
+        try
+        {
+            JSON::Object entry(lines[i]);
+            if(i > 0)
+                CHECK(entry.getString("s") == "two\nlines");
+        }
+        catch(const JSON::Exception&)
+        {
+            std::cerr << "line " << i << " does not parse: " << lines[i] << std::endl;
+            ++failures;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
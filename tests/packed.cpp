@@ -0,0 +1,123 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Only cJSON_ParsePacked and cJSON_CreatePacked*Array pack numbers, so trees
+ * from the other calls can still be walked through ->child. The wrapper packs
+ * parsed text only in parsePacked().
+ */
+
+#include <JSON/Array.h>
+#include <JSON/Object.h>
+#include <JSON/cJSON/cJSON.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+static int allocations = 0;
+
+static void*
+counting_malloc(size_t size)
+{
+    ++allocations;
+    return malloc(size);
+}
+
+static int
+walk(cJSON* first)
+{
+    int n = 0;
+    for(cJSON* c = first; c; c = c->next)
+        ++n;
+    return n;
+}
+
+int
+main()
+{
+    std::string text = "[";
+    int numbers[40];
+    for(int i = 0; i < 40; ++i)
+    {
+        text += std::string(i ? "," : "") + std::to_string(i);
+        numbers[i] = i;
+    }
+    text += "]";
+
+    cJSON* parsed = cJSON_Parse(text.c_str());
+    CHECK(!(parsed->type & cJSON_IsPacked));
+    CHECK(walk(parsed->child) == 40);
+    cJSON_Delete(parsed);
+
+    cJSON* created = cJSON_CreateIntArray(numbers, 40);
+    CHECK(walk(created->child) == 40);
+    cJSON_Delete(created);
+
+    cJSON* packed = cJSON_ParsePacked(text.c_str());
+    CHECK(packed->type & cJSON_IsPacked);
+    CHECK(cJSON_GetArraySize(packed) == 40);
+    CHECK(walk(cJSON_GetChild(packed)) == 40);
+    CHECK(cJSON_GetArrayItem(packed, 39)->valueint == 39);
+    char* printed = cJSON_PrintUnformatted(packed);
+    CHECK(text == printed);
+    cJSON_free(printed);
+    cJSON_Delete(packed);
+
+    cJSON* createdPacked = cJSON_CreatePackedIntArray(numbers, 40);
+    CHECK(createdPacked->type & cJSON_IsPacked);
+    CHECK(walk(cJSON_GetChild(createdPacked)) == 40);
+    cJSON_Delete(createdPacked);
+
+    cJSON* few = cJSON_CreatePackedIntArray(numbers, 3);
+    CHECK(!(few->type & cJSON_IsPacked));
+    CHECK(walk(few->child) == 3);
+    cJSON_Delete(few);
+
+    /* the wrapper packs only when asked to, a node per number costs an allocation each */
+    cJSON_Hooks hooks = { counting_malloc, free };
+    cJSON_InitHooks(&hooks);
+    allocations = 0;
+    JSON::Array array(text);
+    CHECK(allocations > 40);
+    allocations = 0;
+    JSON::Array packedArray = JSON::Array::parsePacked(text);
+    CHECK(allocations < 10);
+    JSON::Object packedObject = JSON::Object::parsePacked("{\"a\":" + text + "}");
+    cJSON_InitHooks(0);
+
+    CHECK(array.length() == 40 && packedArray.length() == 40);
+    CHECK(array.getInt<int>(20) == 20 && packedArray.getInt<int>(20) == 20);
+    CHECK(array.toString() == text && packedArray.toString() == text);
+    JSON::Array member;
+    CHECK(packedObject.getJSONArray("a", member).getInt<int>(39) == 39);
+    CHECK(THROWS(JSON::Object::parsePacked(text)));
+
+    return failures ? 1 : 0;
+}
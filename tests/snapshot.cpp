@@ -0,0 +1,190 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * Snapshots hold offsets and load anywhere. cJSON_LoadSnapshot refuses an
+ * image with an offset outside the block or counts that do not fit it, so a
+ * damaged or hostile snapshot file is rejected rather than walked.
+ */
+
+#include <JSON/Array.h>
+#include <JSON/Object.h>
+#include <JSON/cJSON/cJSON.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "check.h"
+
+static std::string
+print(cJSON* item)
+{
+    char* text = cJSON_PrintUnformatted(item);
+    std::string printed(text);
+    cJSON_free(text);
+    return printed;
+}
+
+/* a copy of the image, loaded where malloc puts it */
+static cJSON*
+load(const void* image, size_t size, void** copy)
+{
+    *copy = malloc(size);
+    memcpy(*copy, image, size);
+    return cJSON_LoadSnapshot(*copy, size, 0);
+}
+
+static void
+damage(void* image, size_t at, uint64_t value)
+{
+    memcpy((char*)image + at, &value, 8);
+}
+
+int
+main()
+{
+    std::string text = "{\"numbers\":[";
+    for(int i = 0; i < 20; ++i)
+        text += std::string(i ? "," : "") + std::to_string(i * 3);
+    text += "],\"people\":[";
+    for(int i = 0; i < 20; ++i)
+        text += std::string(i ? "," : "") + "{\"name\":\"Someone With A Long Name\",\"id\":" + std::to_string(i) + "}";
+    text += "]";
+    for(int i = 0; i < 20; ++i)
+        text += ",\"member" + std::to_string(i) + "\":\"value " + std::to_string(i) + "\"";
+    text += "}";
+
+    cJSON* parsed = cJSON_ParsePacked(text.c_str());
+    cJSON* tree = cJSON_Dedupe(parsed, 0);
+    const std::string expected = print(parsed);
+    cJSON_Delete(parsed);
+
+    size_t size = 0;
+    void* image = cJSON_Snapshot(tree, &size);
+    CHECK(image != 0);
+    size_t writable = cJSON_SnapshotWritable(image, size);
+    CHECK(writable > 0 && writable < size);
+
+    /* the words that loading changes are the offsets */
+    void* copy;
+    cJSON* root = load(image, size, &copy);
+    CHECK(root != 0);
+    std::vector<size_t> offsets;
+    for(size_t at = 0; at + 8 <= size; at += 8)
+        if(memcmp((char*)image + at, (char*)copy + at, 8))
+            offsets.push_back(at);
+    CHECK(offsets.size() > 60);
+    CHECK(offsets.back() < writable);
+    if(root)
+    {
+        CHECK(print(root) == expected);
+        CHECK(cJSON_GetObjectItem(root, "member17") != 0);
+        cJSON_Delete(root);
+    }
+    free(copy);
+
+    /* every offset moved out of the image is refused, one moved off its boundary
+       is refused unless it still lands on text that ends inside the image */
+    for(size_t i = 0; i < offsets.size(); ++i)
+    {
+        uint64_t word;
+        memcpy(&word, (char*)image + offsets[i], 8);
+        const uint64_t damaged[] = { size, (uint64_t)-8, word + 1 };
+        for(size_t j = 0; j < sizeof(damaged) / sizeof(damaged[0]); ++j)
+        {
+            void* bad = malloc(size);
+            memcpy(bad, image, size);
+            damage(bad, offsets[i], damaged[j]);
+            root = load(bad, size, &copy);
+            free(bad);
+            if(root)
+            {
+                if(damaged[j] != word + 1)
+                {
+                    std::cerr << "accepted " << std::hex << damaged[j] << std::dec << " at " << offsets[i] << std::endl;
+                    ++failures;
+                }
+                print(root);
+                cJSON_Delete(root);
+            }
+            free(copy);
+        }
+    }
+
+    /* a truncated image, and counts whose sizes wrap around; the node count
+       follows the magic, version, layout and size */
+    root = load(image, size - 8, &copy);
+    CHECK(root == 0);
+    free(copy);
+    const uint64_t wrapping[] = { (uint64_t)-1 / 8 + 1, (uint64_t)-1 / 64 + 1, (uint64_t)-1 };
+    for(size_t j = 0; j < sizeof(wrapping) / sizeof(wrapping[0]); ++j)
+        for(size_t at = 24; at < 48; at += 8)
+        {
+            void* bad = malloc(size);
+            memcpy(bad, image, size);
+            damage(bad, at, wrapping[j]);
+            CHECK(cJSON_SnapshotWritable(bad, size) == 0);
+            root = load(bad, size, &copy);
+            CHECK(root == 0);
+            free(bad);
+            free(copy);
+        }
+
+    /* a file written and mapped through the wrapper */
+    char path[] = "/tmp/snapshotXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    JSON::Object(expected).writeSnapshot(path);
+    JSON::Object mapped = JSON::Object::mapSnapshot(path);
+    CHECK(mapped.toString() == expected);
+    JSON::Array people;
+    JSON::Object person;
+    CHECK(mapped.getJSONArray("people", people).getJSONObject(19, person).getString("name") == "Someone With A Long Name");
+
+    unlink(path);
+
+    /* and a damaged one, in a file of its own as the mapping above reads its file */
+    char damagedPath[] = "/tmp/snapshotXXXXXX";
+    fd = mkstemp(damagedPath);
+    CHECK(fd >= 0);
+    damage(image, offsets[0], size);
+    CHECK(write(fd, image, size) == (ssize_t)size);
+    close(fd);
+    CHECK(THROWS(JSON::Object::mapSnapshot(damagedPath)));
+    unlink(damagedPath);
+
+    cJSON_free(image);
+    cJSON_Delete(tree);
+    return failures ? 1 : 0;
+}
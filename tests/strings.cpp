@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+ * String values keep NUL bytes on every path that stores a std::string.
+ */
+
+#include <JSON/Array.h>
+#include <JSON/Object.h>
+
+#include <iostream>
+#include <string>
+
+#include "check.h"
+
+int
+main()
+{
+    const std::string value("a\0b", 3);
+
+    JSON::Object::Kvps kvps;
+    kvps["k"] = value;
+    JSON::Object fromMap(kvps);
+    CHECK(fromMap.getString("k") == value);
+
+    JSON::Object object;
+    object.put("k", value);
+    CHECK(object.getString("k") == value);
+    object.append("list", value);
+    JSON::Array list;
+    CHECK(object.getJSONArray("list", list).getString(0) == value);
+
+    JSON::Array array;
+    array.append(value);
+    CHECK(array.getString(0) == value);
+
+    JSON::Object parsed(fromMap.toString());
+    CHECK(parsed.getString("k") == value);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2016, Steve Williams (bitbytedog)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the <organization> nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/*
+ * Rendered templates are always valid JSON: text for a json slot is checked,
+ * a NULL string is refused and a double with no JSON number renders as null,
+ * as JSON::toString() prints it.
+ */
+
+#include <JSON/Object.h>
+#include <JSON/Template.h>
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "check.h"
+
+int
+main()
+{
+    JSON::Template tpl("{\"name\":\"${name}\",\"extra\":\"${extra:json}\",\"ratio\":\"${ratio:double}\"}");
+    JSON::Template::Values values(tpl);
+
+    CHECK(THROWS(values.set("extra", "")));
+    CHECK(THROWS(values.set("extra", "{\"a\":")));
+    CHECK(THROWS(values.set("extra", std::string("1,\"b\":2"))));
+    CHECK(THROWS(values.set("name", (const char*)0)));
+    CHECK(THROWS(values.set("extra", (const char*)0)));
+
+    values.set("name", "n").set("extra", "[1,2]").set("ratio", std::nan(""));
+    CHECK(tpl.render(values) == "{\"name\":\"n\",\"extra\":[1,2],\"ratio\":null}");
+
+    values.set("ratio", std::numeric_limits<double>::infinity());
+    std::string rendered = tpl.render(values);
+    JSON::Object parsed(rendered);
+    CHECK(parsed.toString() == rendered);
+
+    JSON::Object obj;
+    obj.put("ratio", -std::numeric_limits<double>::infinity());
+    CHECK(obj.toString() == "{\"ratio\":null}");
+
+    return failures ? 1 : 0;
+}
@@ -40,25 +40,47 @@
  * UK, TA3 5RS.
  */
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #include <JSON/Object.h>
 
+static void usage(const char* name)
+{
+    std::cerr << "usage: " << name << " [-s snapshot] file" << std::endl;
+    std::exit(1);
+}
+
 int main (int argc, char* argv[])
 {
+    const char* snapshot = 0;
+    int arg = 1;
+
+    if(arg < argc && 0 == std::strcmp(argv[arg], "-s"))
+    {
+        if(++arg == argc)
+            usage(argv[0]);
+        snapshot = argv[arg++];
+    }
+    if(arg + 1 != argc)
+        usage(argv[0]);
+
     std::ifstream is;
 
-    is.open(argv[1], std::ifstream::in);
+    is.open(argv[arg], std::ifstream::in);
 
     if(is.is_open())
     {
         JSON::Object oids(is);
-        std::cout << oids << std::endl;
+        if(snapshot)
+            oids.writeSnapshot(snapshot);
+        else
+            std::cout << oids << std::endl;
     }
     else
     {
-        std::cerr << "unable to open file: " << argv[1] << std::endl;
+        std::cerr << "unable to open file: " << argv[arg] << std::endl;
     }
     std::exit(0);
 }